@@ -0,0 +1,246 @@
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <bench/Benchmark.hpp>
+
+namespace bench {
+
+double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// 再現性のため固定シードの LCG で limbs 個ぶんの10進数字列を作る
+std::string random_digits(std::size_t limbs, unsigned long long seed) {
+    std::string s(limbs * 9, '0');
+    unsigned long long x = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        s[i] = static_cast<char>('0' + (x >> 33) % 10);
+    }
+    s[0] = static_cast<char>('1' + (x >> 33) % 9);
+    return s;
+}
+
+State::State(std::size_t limbs, std::size_t iterations)
+    : _limbs(limbs), _iterations(iterations), _startNs(0), _elapsedNs(0) {}
+
+std::size_t State::limbs() const {
+    return _limbs;
+}
+
+std::size_t State::iterations() const {
+    return _iterations;
+}
+
+void State::start() {
+    _startNs = now_ns();
+}
+
+void State::stop() {
+    _elapsedNs += now_ns() - _startNs;
+}
+
+double State::elapsedNs() const {
+    return _elapsedNs;
+}
+
+Runner::Runner()
+    : _entries(), _filter(), _minLimbs(1), _maxLimbs(1000000), _multiplier(10),
+      _minTime(0.2), _maxOpTime(30.0), _format("console"), _out() {}
+
+void Runner::add(const std::string& name, Function fn, std::size_t maxLimbs) {
+    Entry entry;
+    entry.name = name;
+    entry.fn = fn;
+    entry.maxLimbs = maxLimbs;
+    _entries.push_back(entry);
+}
+
+namespace {
+
+bool match_option(const std::string& arg, const char* name, std::string& value) {
+    std::string prefix = std::string("--") + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '"' || s[i] == '\\') {
+            out += '\\';
+        }
+        out += s[i];
+    }
+    return out;
+}
+
+}  // namespace
+
+bool Runner::parseArgs(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        if (match_option(arg, "filter", value)) {
+            _filter = value;
+        } else if (match_option(arg, "min-limbs", value)) {
+            _minLimbs = std::strtoul(value.c_str(), 0, 10);
+        } else if (match_option(arg, "max-limbs", value)) {
+            _maxLimbs = std::strtoul(value.c_str(), 0, 10);
+        } else if (match_option(arg, "multiplier", value)) {
+            _multiplier = std::strtoul(value.c_str(), 0, 10);
+        } else if (match_option(arg, "min-time", value)) {
+            _minTime = std::strtod(value.c_str(), 0);
+        } else if (match_option(arg, "max-op-time", value)) {
+            _maxOpTime = std::strtod(value.c_str(), 0);
+        } else if (match_option(arg, "format", value)) {
+            _format = value;
+        } else if (match_option(arg, "out", value)) {
+            _out = value;
+        } else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (_minLimbs == 0 || _multiplier < 2
+            || (_format != "console" && _format != "csv" && _format != "json")) {
+        std::cerr << "invalid option value" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 反復回数を 10 倍ずつ増やし、合計時間が min-time を超えたところで確定する
+Result Runner::measure(const Entry& entry, std::size_t limbs) const {
+    std::size_t iterations = 1;
+    double elapsed = 0;
+    for (;;) {
+        State state(limbs, iterations);
+        entry.fn(state);
+        elapsed = state.elapsedNs();
+        if (elapsed >= _minTime * 1e9 || iterations >= 1000000000) {
+            break;
+        }
+        double perOp = elapsed / iterations;
+        std::size_t next = iterations * 10;
+        if (perOp > 0) {
+            double needed = _minTime * 1e9 / perOp * 1.4;
+            if (needed < next) {
+                next = static_cast<std::size_t>(needed) + 1;
+            }
+        }
+        iterations = next > iterations ? next : iterations + 1;
+    }
+    Result result;
+    result.name = entry.name;
+    result.limbs = limbs;
+    result.iterations = iterations;
+    result.nsPerOp = elapsed / iterations;
+    result.limbsPerSec = result.nsPerOp > 0 ? limbs * 1e9 / result.nsPerOp : 0;
+    return result;
+}
+
+void Runner::report(const std::vector<Result>& results, std::ostream& os,
+                    bool withHeader) const {
+    if (_format == "csv") {
+        if (withHeader) {
+            os << "name,limbs,iterations,ns_per_op,limbs_per_sec\n";
+        }
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            os << r.name << ',' << r.limbs << ',' << r.iterations << ','
+               << std::fixed << std::setprecision(1) << r.nsPerOp << ','
+               << std::setprecision(0) << r.limbsPerSec << '\n';
+        }
+    } else if (_format == "json") {
+        os << "{\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            os << (i ? ",\n" : "\n")
+               << "    {\"name\": \"" << json_escape(r.name) << "\""
+               << ", \"limbs\": " << r.limbs
+               << ", \"iterations\": " << r.iterations
+               << std::fixed << std::setprecision(1)
+               << ", \"ns_per_op\": " << r.nsPerOp
+               << std::setprecision(0)
+               << ", \"limbs_per_sec\": " << r.limbsPerSec << "}";
+        }
+        os << "\n  ]\n}\n";
+    } else {
+        if (withHeader) {
+            os << std::left << std::setw(16) << "benchmark" << std::right
+               << std::setw(10) << "limbs" << std::setw(12) << "iterations"
+               << std::setw(18) << "ns/op" << std::setw(18) << "limbs/s" << '\n';
+        }
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            os << std::left << std::setw(16) << r.name << std::right
+               << std::setw(10) << r.limbs << std::setw(12) << r.iterations
+               << std::fixed << std::setprecision(1) << std::setw(18) << r.nsPerOp
+               << std::setprecision(0) << std::setw(18) << r.limbsPerSec << '\n';
+        }
+    }
+}
+
+int Runner::run(int argc, char** argv) {
+    if (!parseArgs(argc, argv)) {
+        return 1;
+    }
+    bool live = (_format == "console" && _out.empty());
+    std::vector<Result> results;
+    if (live) {
+        report(results, std::cout);
+    }
+    for (std::size_t e = 0; e < _entries.size(); ++e) {
+        const Entry& entry = _entries[e];
+        if (!_filter.empty() && entry.name.find(_filter) == std::string::npos) {
+            continue;
+        }
+        std::size_t maxLimbs = _maxLimbs;
+        if (entry.maxLimbs != 0 && entry.maxLimbs < maxLimbs) {
+            maxLimbs = entry.maxLimbs;
+        }
+        for (std::size_t limbs = _minLimbs; limbs <= maxLimbs; limbs *= _multiplier) {
+            Result r = measure(entry, limbs);
+            results.push_back(r);
+            if (live) {
+                std::vector<Result> one(1, r);
+                report(one, std::cout, false);
+                std::cout.flush();
+            } else {
+                std::cerr << r.name << " " << r.limbs << " limbs: "
+                          << r.nsPerOp << " ns/op" << std::endl;
+            }
+            // 1 回で max-op-time を超えたら、より大きいサイズは打ち切る
+            if (r.nsPerOp > _maxOpTime * 1e9) {
+                std::cerr << entry.name << ": skipping sizes above " << limbs
+                          << " limbs (exceeded --max-op-time)" << std::endl;
+                break;
+            }
+        }
+    }
+    if (!_out.empty()) {
+        std::ofstream ofs(_out.c_str());
+        if (!ofs) {
+            std::cerr << "cannot open " << _out << std::endl;
+            return 1;
+        }
+        report(results, ofs);
+    } else if (_format != "console") {
+        report(results, std::cout);
+    }
+    return 0;
+}
+
+}  // namespace bench
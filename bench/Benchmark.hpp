@@ -0,0 +1,72 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// 1 回の計測。ベンチマーク関数は準備を済ませてから start()/stop() で
+// iterations() 回のループを囲む。
+class State {
+ public:
+    State(std::size_t limbs, std::size_t iterations);
+    std::size_t limbs() const;
+    std::size_t iterations() const;
+    void start();
+    void stop();
+    double elapsedNs() const;
+
+ private:
+    std::size_t _limbs;
+    std::size_t _iterations;
+    double _startNs;
+    double _elapsedNs;
+};
+
+typedef void (*Function)(State& state);
+
+struct Result {
+    std::string name;
+    std::size_t limbs;
+    std::size_t iterations;
+    double nsPerOp;
+    double limbsPerSec;
+};
+
+class Runner {
+ public:
+    Runner();
+    // maxLimbs (0 なら無制限) を超えるサイズはこのベンチマークでは測らない
+    void add(const std::string& name, Function fn, std::size_t maxLimbs = 0);
+    // --filter=SUBSTR --min-limbs=N --max-limbs=N --multiplier=N
+    // --min-time=SEC --max-op-time=SEC --format=console|csv|json --out=FILE
+    int run(int argc, char** argv);
+
+ private:
+    struct Entry {
+        std::string name;
+        Function fn;
+        std::size_t maxLimbs;
+    };
+
+    std::vector<Entry> _entries;
+    std::string _filter;
+    std::size_t _minLimbs;
+    std::size_t _maxLimbs;
+    std::size_t _multiplier;
+    double _minTime;
+    double _maxOpTime;
+    std::string _format;
+    std::string _out;
+
+    bool parseArgs(int argc, char** argv);
+    Result measure(const Entry& entry, std::size_t limbs) const;
+    void report(const std::vector<Result>& results, std::ostream& os,
+                bool withHeader = true) const;
+};
+
+double now_ns();
+std::string random_digits(std::size_t limbs, unsigned long long seed);
+
+}  // namespace bench
@@ -0,0 +1,130 @@
+#include <string>
+
+#include <bench/Benchmark.hpp>
+#include <srcs/BigInt.hpp>
+
+namespace {
+
+// 最適化で結果が捨てられないよう、計測結果の大きさを書き込む
+volatile std::size_t g_sink;
+
+BigInt random_bigint(std::size_t limbs, unsigned long long seed) {
+    return BigInt(bench::random_digits(limbs, seed));
+}
+
+void bm_add(bench::State& state) {
+    BigInt a = random_bigint(state.limbs(), 1);
+    BigInt b = random_bigint(state.limbs(), 2);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt c = a + b;
+        g_sink = c.size();
+    }
+    state.stop();
+}
+
+void bm_sub(bench::State& state) {
+    BigInt a = random_bigint(state.limbs(), 1);
+    BigInt b = random_bigint(state.limbs(), 2);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt c = a - b;
+        g_sink = c.size();
+    }
+    state.stop();
+}
+
+void bm_mul(bench::State& state) {
+    BigInt a = random_bigint(state.limbs(), 1);
+    BigInt b = random_bigint(state.limbs(), 2);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt c = a * b;
+        g_sink = c.size();
+    }
+    state.stop();
+}
+
+void bm_square(bench::State& state) {
+    BigInt a = random_bigint(state.limbs(), 1);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt c = a * a;
+        g_sink = c.size();
+    }
+    state.stop();
+}
+
+// 2n limb / n limb
+void bm_divmod(bench::State& state) {
+    BigInt a = random_bigint(2 * state.limbs(), 1);
+    BigInt b = random_bigint(state.limbs(), 2);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt q, r;
+        BigInt::divmod(a, b, q, r);
+        g_sink = q.size() + r.size();
+    }
+    state.stop();
+}
+
+// 1 limb の底を、結果がおよそ n limb になるまで累乗する
+void bm_pow(bench::State& state) {
+    BigInt base(999999937);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt c = BigInt::pow(base, state.limbs());
+        g_sink = c.size();
+    }
+    state.stop();
+}
+
+void bm_to_string(bench::State& state) {
+    BigInt a = random_bigint(state.limbs(), 1);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        std::string s = a.toString();
+        g_sink = s.size();
+    }
+    state.stop();
+}
+
+void bm_parse(bench::State& state) {
+    std::string s = bench::random_digits(state.limbs(), 1);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt a(s);
+        g_sink = a.size();
+    }
+    state.stop();
+}
+
+// nextPrime は 1000 limb で 1 回数百秒かかるので、8192 bit (274 limb) までに限る
+const std::size_t kNextPrimeMaxLimbs = 274;
+
+// n limb の乱数の次の素数 (ふるいと BPSW 判定)
+void bm_next_prime(bench::State& state) {
+    BigInt a = random_bigint(state.limbs(), 1);
+    state.start();
+    for (std::size_t i = 0; i < state.iterations(); ++i) {
+        BigInt p = BigInt::nextPrime(a);
+        g_sink = p.size();
+    }
+    state.stop();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bench::Runner runner;
+    runner.add("add", bm_add);
+    runner.add("sub", bm_sub);
+    runner.add("mul", bm_mul);
+    runner.add("square", bm_square);
+    runner.add("divmod", bm_divmod);
+    runner.add("pow", bm_pow);
+    runner.add("toString", bm_to_string);
+    runner.add("parse", bm_parse);
+    runner.add("nextPrime", bm_next_prime, kNextPrimeMaxLimbs);
+    return runner.run(argc, argv);
+}
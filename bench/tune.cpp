@@ -0,0 +1,203 @@
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <bench/Benchmark.hpp>
+#include <srcs/BigInt.hpp>
+
+// 各アルゴリズムの切り替え点を探し、bigint_tuning.hpp を書き出す。
+// サイズ n ごとに「n でちょうど 1 段だけ分割する閾値」と「n では分割しない
+// 閾値」を実行時に切り替えて比べ、分割側が 3 サイズ続けて速くなった最初の
+// n を採用する (GMP の tuneup と同じ考え方)。
+
+namespace {
+
+volatile std::size_t g_sink;
+
+struct Operands {
+    BigInt a;
+    BigInt b;
+};
+
+typedef void (*Op)(const Operands& x);
+typedef void (*Setter)(std::size_t value);
+
+void op_mul(const Operands& x) {
+    BigInt c = x.a * x.b;
+    g_sink = c.size();
+}
+
+void op_divmod(const Operands& x) {
+    BigInt q, r;
+    BigInt::divmod(x.a, x.b, q, r);
+    g_sink = q.size() + r.size();
+}
+
+// 閾値は両方向で共有するので、書き出しと読み戻しをまとめて測る
+void op_radix(const Operands& x) {
+    std::string s = x.a.toString(16);
+    BigInt back(s, 16);
+    g_sink = s.size() + back.size();
+}
+
+Operands make_mul(std::size_t n) {
+    Operands x;
+    x.a = BigInt(bench::random_digits(n, 1));
+    x.b = BigInt(bench::random_digits(n, 2));
+    return x;
+}
+
+Operands make_divmod(std::size_t n) {
+    Operands x;
+    x.a = BigInt(bench::random_digits(2 * n, 1));
+    x.b = BigInt(bench::random_digits(n, 2));
+    return x;
+}
+
+void set_multiply(std::size_t v) {
+    BigInt::Thresholds t = BigInt::thresholds();
+    t.multiply = v;
+    BigInt::setThresholds(t);
+}
+
+void set_division(std::size_t v) {
+    BigInt::Thresholds t = BigInt::thresholds();
+    t.division = v;
+    BigInt::setThresholds(t);
+}
+
+void set_radix(std::size_t v) {
+    BigInt::Thresholds t = BigInt::thresholds();
+    t.radix = v;
+    BigInt::setThresholds(t);
+}
+
+// 1 回あたりの時間 (ns)。minNs 以上かかる反復回数で 5 回測った最小値。
+double time_op(Op op, const Operands& x, double minNs) {
+    double best = 0;
+    for (int rep = 0; rep < 5; ++rep) {
+        std::size_t iterations = 1;
+        double elapsed;
+        for (;;) {
+            double start = bench::now_ns();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                op(x);
+            }
+            elapsed = bench::now_ns() - start;
+            if (elapsed >= minNs) {
+                break;
+            }
+            iterations *= 2;
+        }
+        double perOp = elapsed / iterations;
+        if (rep == 0 || perOp < best) {
+            best = perOp;
+        }
+    }
+    return best;
+}
+
+struct Search {
+    const char* name;
+    Op op;
+    Operands (*make)(std::size_t n);
+    Setter set;
+    std::size_t lo;
+    std::size_t hi;
+    std::size_t step;
+    // サイズ n の入力に対し、分割する/しない閾値
+    long splitOffset;
+    long baseOffset;
+};
+
+std::size_t find_crossover(const Search& s, double minNs) {
+    std::size_t first = 0;
+    int wins = 0;
+    for (std::size_t n = s.lo; n <= s.hi; ) {
+        Operands x = s.make(n);
+        s.set(static_cast<std::size_t>(static_cast<long>(n) + s.baseOffset));
+        double base = time_op(s.op, x, minNs);
+        s.set(static_cast<std::size_t>(static_cast<long>(n) + s.splitOffset));
+        double split = time_op(s.op, x, minNs);
+        std::cerr << s.name << " n=" << n << " base=" << base
+                  << "ns split=" << split << "ns" << std::endl;
+        if (split < base) {
+            if (wins++ == 0) {
+                first = n;
+            }
+            if (wins == 3) {
+                return first;
+            }
+        } else {
+            wins = 0;
+        }
+        std::size_t inc = n / 16;
+        inc = inc < s.step ? s.step : (inc + s.step - 1) / s.step * s.step;
+        n += inc;
+    }
+    return s.hi;
+}
+
+bool match_option(const std::string& arg, const char* name, std::string& value) {
+    std::string prefix = std::string("--") + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string out = "bigint_tuning.hpp";
+    double minNs = 500000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value;
+        if (match_option(arg, "out", value)) {
+            out = value;
+        } else if (match_option(arg, "min-time-us", value)) {
+            minNs = std::strtod(value.c_str(), 0) * 1000;
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--out=FILE] [--min-time-us=N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // schoolbook <-> Karatsuba: size < MULTIPLY_THRESHOLD なら schoolbook
+    Search mul = { "multiply", op_mul, make_mul, set_multiply, 4, 256, 1, 0, 1 };
+    std::size_t multiply = find_crossover(mul, minNs);
+    set_multiply(multiply);
+
+    // schoolbook <-> Burnikel-Ziegler: 除数 limb 数 < DIVISION_THRESHOLD なら
+    // schoolbook。偶数サイズで 1 段だけ再帰させて比べる。
+    Search div = { "division", op_divmod, make_divmod, set_division, 8, 512, 2, 0, 1 };
+    std::size_t division = find_crossover(div, minNs);
+    set_division(division);
+
+    // 基数変換: limb 数 <= RADIX_THRESHOLD なら単精度の除算・乗算の繰り返し
+    Search radix = { "radix", op_radix, make_mul, set_radix, 4, 512, 1, -1, 0 };
+    std::size_t radixThreshold = find_crossover(radix, minNs) - 1;
+
+    std::ofstream ofs(out.c_str());
+    if (!ofs) {
+        std::cerr << "cannot open " << out << std::endl;
+        return 1;
+    }
+    std::time_t now = std::time(0);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&now));
+    ofs << "// Generated by bigint_tune on " << date << ". Do not edit.\n"
+        << "// Rebuild the library (make re) to pick up these thresholds.\n"
+        << "#pragma once\n\n"
+        << "#define BIGINT_MULTIPLY_THRESHOLD " << multiply << "\n"
+        << "#define BIGINT_DIVISION_THRESHOLD " << division << "\n"
+        << "#define BIGINT_RADIX_THRESHOLD " << radixThreshold << "\n";
+    std::cout << "multiply " << multiply << ", division " << division
+              << ", radix " << radixThreshold << " -> " << out << std::endl;
+    return 0;
+}
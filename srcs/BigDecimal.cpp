@@ -0,0 +1,363 @@
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <srcs/BigDecimal.hpp>
+
+namespace {
+
+const unsigned long kLimbDigits = 9;
+const unsigned long long kBase = 1000000000ULL;
+const unsigned int kPow10[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 捨てた部分が半分より大きい (1)・ちょうど半分 (0)・小さい (-1) と、
+// 捨てた部分が 0 でないかから、絶対値を 1 増やすかを決める
+bool round_increment(BigDecimal::RoundingMode mode, bool negative, bool odd,
+                     int half, bool inexact) {
+    if (!inexact) {
+        return false;
+    }
+    switch (mode) {
+        case BigDecimal::ROUND_UP:
+            return true;
+        case BigDecimal::ROUND_DOWN:
+            return false;
+        case BigDecimal::ROUND_CEILING:
+            return !negative;
+        case BigDecimal::ROUND_FLOOR:
+            return negative;
+        case BigDecimal::ROUND_HALF_UP:
+            return half >= 0;
+        case BigDecimal::ROUND_HALF_DOWN:
+            return half > 0;
+        case BigDecimal::ROUND_HALF_EVEN:
+            return half > 0 || (half == 0 && odd);
+    }
+    return false;
+}
+
+// 最上位の桁の位置 (桁数 + 指数) の大小。指数の差が long に収まらなくてもよい
+int compare_leading(long ea, std::size_t da, long eb, std::size_t db) {
+    if (ea < eb) {
+        return -compare_leading(eb, db, ea, da);
+    }
+    unsigned long gap = static_cast<unsigned long>(ea) - static_cast<unsigned long>(eb);
+    if (da >= db) {
+        return gap == 0 && da == db ? 0 : 1;
+    }
+    unsigned long shortfall = db - da;
+    return gap > shortfall ? 1 : (gap < shortfall ? -1 : 0);
+}
+
+}  // namespace
+
+BigDecimal::BigDecimal()
+    : _unscaled(0), _exponent(0) {}
+
+BigDecimal::BigDecimal(const BigInt& unscaled, long exponent)
+    : _unscaled(unscaled), _exponent(exponent) {}
+
+BigDecimal::BigDecimal(const std::string& str)
+    : _unscaled(0), _exponent(0) {
+    std::size_t i = 0;
+    std::string digits;
+    if (i < str.size() && (str[i] == '-' || str[i] == '+')) {
+        digits += str[i++];
+    }
+    long fraction = 0;
+    bool seenPoint = false;
+    bool seenDigit = false;
+    for (; i < str.size(); ++i) {
+        if (is_digit(str[i])) {
+            digits += str[i];
+            seenDigit = true;
+            if (seenPoint) {
+                ++fraction;
+            }
+        } else if (str[i] == '.' && !seenPoint) {
+            seenPoint = true;
+        } else {
+            break;
+        }
+    }
+    if (!seenDigit) {
+        throw std::invalid_argument("Invalid string for BigDecimal: no digits");
+    }
+    long exponent = 0;
+    if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+        ++i;
+        bool negative = false;
+        if (i < str.size() && (str[i] == '-' || str[i] == '+')) {
+            negative = (str[i++] == '-');
+        }
+        if (i == str.size()) {
+            throw std::invalid_argument("Invalid string for BigDecimal: empty exponent");
+        }
+        for (; i < str.size() && is_digit(str[i]); ++i) {
+            if (exponent > (std::numeric_limits<long>::max() - 9) / 10) {
+                throw std::overflow_error("BigDecimal exponent out of range");
+            }
+            exponent = exponent * 10 + (str[i] - '0');
+        }
+        if (negative) {
+            exponent = -exponent;
+        }
+    }
+    if (i != str.size()) {
+        throw std::invalid_argument("Invalid string for BigDecimal: unexpected character");
+    }
+    _unscaled = BigInt(digits);
+    _exponent = exponent - fraction;
+}
+
+const BigInt& BigDecimal::unscaled() const {
+    return _unscaled;
+}
+
+long BigDecimal::exponent() const {
+    return _exponent;
+}
+
+std::string BigDecimal::toString() const {
+    std::string digits = _unscaled.abs().toString();
+    if (_exponent >= 0) {
+        if (!_unscaled.isZero()) {
+            digits.append(static_cast<std::size_t>(_exponent), '0');
+        }
+    } else {
+        std::size_t fraction = static_cast<std::size_t>(-_exponent);
+        if (digits.size() <= fraction) {
+            digits.insert(0, fraction - digits.size() + 1, '0');
+        }
+        digits.insert(digits.size() - fraction, 1, '.');
+    }
+    if (_unscaled.isNegative()) {
+        digits.insert(digits.begin(), '-');
+    }
+    return digits;
+}
+
+// |x| * 10^k。9 桁単位は limb をずらすだけで、残りは 1 limb の乗算
+BigInt BigDecimal::scale_up(const BigInt& x, unsigned long k) {
+    BigInt res = x.abs().shift_block_left(k / kLimbDigits).scalar_mul(kPow10[k % kLimbDigits]);
+    return x.isNegative() ? -res : res;
+}
+
+// |x| / 10^k (k >= 1) を切り捨てる。捨てた部分と 10^k / 2 の大小を half に、
+// 捨てた部分が 0 でないかを inexact に返す。
+// k = 9q + r (1 <= r <= 9) として下位 q limb は捨て、残りを 10^r で割る。
+BigInt BigDecimal::scale_down(const BigInt& x, unsigned long k,
+                              int& half, bool& inexact) {
+    unsigned long q = (k - 1) / kLimbDigits;
+    unsigned long r = k - q * kLimbDigits;
+    const BigInt::DigitVector& digits = x._digits;
+    std::size_t dropped = q < digits.size() ? q : digits.size();
+    bool sticky = false;
+    for (std::size_t i = 0; i < dropped; ++i) {
+        sticky = sticky || digits[i] != 0;
+    }
+
+    BigInt res;
+    unsigned long long divisor = kPow10[r];
+    unsigned long long rem = 0;
+    if (dropped < digits.size()) {
+        res._digits.resize(digits.size() - dropped);
+        BigInt::DigitType* d = mutable_data(res._digits);
+        for (std::size_t i = digits.size(); i > dropped; --i) {
+            unsigned long long cur = rem * kBase + digits[i - 1];
+            d[i - 1 - dropped] = static_cast<BigInt::DigitType>(cur / divisor);
+            rem = cur % divisor;
+        }
+    } else {
+        res._digits.push_back(0);
+    }
+    res.normalize();
+
+    // 捨てた桁の最上位の数字と、それより下に 0 でない桁があるか
+    unsigned long long first = rem / kPow10[r - 1];
+    sticky = sticky || rem % kPow10[r - 1] != 0;
+    inexact = first != 0 || sticky;
+    if (first != 5) {
+        half = first > 5 ? 1 : -1;
+    } else {
+        half = sticky ? 1 : 0;
+    }
+    return res;
+}
+
+bool BigDecimal::is_odd(const BigInt& x) {
+    return !x._digits.empty() && x._digits[0] % 2 != 0;
+}
+
+BigDecimal BigDecimal::rescale(long exponent, RoundingMode mode) const {
+    if (exponent <= _exponent) {
+        return BigDecimal(scale_up(_unscaled, static_cast<unsigned long>(_exponent - exponent)),
+                          exponent);
+    }
+    int half;
+    bool inexact;
+    BigInt q = scale_down(_unscaled, static_cast<unsigned long>(exponent - _exponent),
+                          half, inexact);
+    bool negative = _unscaled.isNegative();
+    if (round_increment(mode, negative, is_odd(q), half, inexact)) {
+        ++q;
+    }
+    return BigDecimal(negative ? -q : q, exponent);
+}
+
+BigDecimal BigDecimal::stripTrailingZeros() const {
+    if (_unscaled.isZero()) {
+        return BigDecimal(BigInt(0), 0);
+    }
+    const BigInt::DigitVector& digits = _unscaled._digits;
+    unsigned long k = 0;
+    std::size_t i = 0;
+    while (digits[i] == 0) {
+        k += kLimbDigits;
+        ++i;
+    }
+    for (BigInt::DigitType v = digits[i]; v % 10 == 0; v /= 10) {
+        ++k;
+    }
+    if (k == 0) {
+        return *this;
+    }
+    int half;
+    bool inexact;
+    BigInt q = scale_down(_unscaled, k, half, inexact);
+    return BigDecimal(_unscaled.isNegative() ? -q : q, _exponent + static_cast<long>(k));
+}
+
+BigDecimal& BigDecimal::operator+=(const BigDecimal& rhs) {
+    // 0 との加算で相手を指数の小さい方へ桁上げしない (1e1000000000000 + 0 など)
+    if (rhs._unscaled.isZero()) {
+        return *this;
+    }
+    if (_unscaled.isZero()) {
+        return *this = rhs;
+    }
+    if (_exponent > rhs._exponent) {
+        *this = rescale(rhs._exponent);
+    }
+    if (rhs._exponent > _exponent) {
+        _unscaled += rhs.rescale(_exponent)._unscaled;
+    } else {
+        _unscaled += rhs._unscaled;
+    }
+    return *this;
+}
+
+BigDecimal& BigDecimal::operator-=(const BigDecimal& rhs) {
+    return *this += -rhs;
+}
+
+BigDecimal& BigDecimal::operator*=(const BigDecimal& rhs) {
+    _unscaled *= rhs._unscaled;
+    _exponent += rhs._exponent;
+    return *this;
+}
+
+BigDecimal BigDecimal::operator-() const {
+    return BigDecimal(-_unscaled, _exponent);
+}
+
+// a / b を 10^exponent の桁まで: (ua / ub) * 10^(ea - eb - exponent) を整数に丸める
+BigDecimal BigDecimal::divide(const BigDecimal& divisor, long exponent,
+                              RoundingMode mode) const {
+    if (divisor._unscaled.isZero()) {
+        throw std::runtime_error("Division by zero");
+    }
+    long shift = _exponent - divisor._exponent - exponent;
+    BigInt n = _unscaled.abs();
+    BigInt d = divisor._unscaled.abs();
+    if (shift >= 0) {
+        n = scale_up(n, static_cast<unsigned long>(shift));
+    } else {
+        d = scale_up(d, static_cast<unsigned long>(-shift));
+    }
+    BigInt q, r;
+    BigInt::divmod(n, d, q, r);
+    bool negative = _unscaled.isNegative() != divisor._unscaled.isNegative();
+    if (round_increment(mode, negative, is_odd(q), (r + r).compare(d), !r.isZero())) {
+        ++q;
+    }
+    return BigDecimal(negative ? -q : q, exponent);
+}
+
+int BigDecimal::compare(const BigDecimal& rhs) const {
+    int sign = _unscaled.isZero() ? 0 : (_unscaled.isNegative() ? -1 : 1);
+    int rhsSign = rhs._unscaled.isZero() ? 0 : (rhs._unscaled.isNegative() ? -1 : 1);
+    if (sign != rhsSign) {
+        return sign < rhsSign ? -1 : 1;
+    }
+    if (sign == 0) {
+        return 0;
+    }
+    // 最上位の桁の位置が違えば桁を揃えずに決まる。同じなら揃える桁数は桁数の差以下
+    int leading = compare_leading(_exponent, _unscaled.digitCount(),
+                                  rhs._exponent, rhs._unscaled.digitCount());
+    if (leading != 0) {
+        return sign * leading;
+    }
+    if (_exponent == rhs._exponent) {
+        return _unscaled.compare(rhs._unscaled);
+    }
+    if (_exponent > rhs._exponent) {
+        return rescale(rhs._exponent)._unscaled.compare(rhs._unscaled);
+    }
+    return _unscaled.compare(rhs.rescale(_exponent)._unscaled);
+}
+
+bool BigDecimal::operator==(const BigDecimal& rhs) const {
+    return compare(rhs) == 0;
+}
+
+bool BigDecimal::operator!=(const BigDecimal& rhs) const {
+    return compare(rhs) != 0;
+}
+
+bool BigDecimal::operator<(const BigDecimal& rhs) const {
+    return compare(rhs) < 0;
+}
+
+bool BigDecimal::operator<=(const BigDecimal& rhs) const {
+    return compare(rhs) <= 0;
+}
+
+bool BigDecimal::operator>(const BigDecimal& rhs) const {
+    return compare(rhs) > 0;
+}
+
+bool BigDecimal::operator>=(const BigDecimal& rhs) const {
+    return compare(rhs) >= 0;
+}
+
+const BigDecimal operator+(const BigDecimal& lhs, const BigDecimal& rhs) {
+    BigDecimal result(lhs);
+    result += rhs;
+    return result;
+}
+
+const BigDecimal operator-(const BigDecimal& lhs, const BigDecimal& rhs) {
+    BigDecimal result(lhs);
+    result -= rhs;
+    return result;
+}
+
+const BigDecimal operator*(const BigDecimal& lhs, const BigDecimal& rhs) {
+    BigDecimal result(lhs);
+    result *= rhs;
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& os, const BigDecimal& num) {
+    os << num.toString();
+    return os;
+}
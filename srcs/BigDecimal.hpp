@@ -0,0 +1,70 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include <srcs/BigInt.hpp>
+
+// unscaled * 10^exponent で表す 10 進の固定小数点数。
+// BigInt の limb が 10^9 進なので、10^k 倍・10^k 分の 1 は 9 桁単位を
+// limb のずらし、残りを 1 limb の乗除算で行い、10 の冪との多倍長演算をしない。
+// 加減乗算は丸めなしで厳密。除算は結果の指数と丸め方を指定する。
+// 加減算の結果の指数は小さい方に揃うが、0 を足し引きしたときは相手の指数のまま。
+class BigDecimal {
+ public:
+    enum RoundingMode {
+        ROUND_UP,         // 0 から遠い方へ
+        ROUND_DOWN,       // 0 の方へ (切り捨て)
+        ROUND_CEILING,    // +無限大の方へ
+        ROUND_FLOOR,      // -無限大の方へ
+        ROUND_HALF_UP,    // 四捨五入 (ちょうど半分は 0 から遠い方)
+        ROUND_HALF_DOWN,  // ちょうど半分は 0 の方
+        ROUND_HALF_EVEN   // ちょうど半分は偶数の方 (銀行丸め)
+    };
+
+    BigDecimal();
+    explicit BigDecimal(const BigInt& unscaled, long exponent = 0);
+    // "-12.345", "1e-7", "6.02E+23" など
+    explicit BigDecimal(const std::string& str);
+
+    const BigInt& unscaled() const;
+    long exponent() const;
+    // 指数表記を使わない 10 進表記
+    std::string toString() const;
+
+    // 指数を exponent に揃える。下げるときは厳密、上げるときは mode で丸める。
+    BigDecimal rescale(long exponent, RoundingMode mode = ROUND_HALF_EVEN) const;
+    // 値を変えずに unscaled の末尾の 0 を指数に移す
+    BigDecimal stripTrailingZeros() const;
+
+    BigDecimal& operator+=(const BigDecimal& rhs);
+    BigDecimal& operator-=(const BigDecimal& rhs);
+    BigDecimal& operator*=(const BigDecimal& rhs);
+    BigDecimal operator-() const;
+    // 指数 exponent の桁まで求めて mode で丸めた商
+    BigDecimal divide(const BigDecimal& divisor, long exponent,
+                      RoundingMode mode = ROUND_HALF_EVEN) const;
+
+    // 値としての比較 (1.0 と 1.00 は等しい)
+    int compare(const BigDecimal& rhs) const;
+    bool operator==(const BigDecimal& rhs) const;
+    bool operator!=(const BigDecimal& rhs) const;
+    bool operator<(const BigDecimal& rhs) const;
+    bool operator<=(const BigDecimal& rhs) const;
+    bool operator>(const BigDecimal& rhs) const;
+    bool operator>=(const BigDecimal& rhs) const;
+
+ private:
+    BigInt _unscaled;
+    long _exponent;
+
+    static BigInt scale_up(const BigInt& x, unsigned long k);
+    static BigInt scale_down(const BigInt& x, unsigned long k,
+                             int& half, bool& inexact);
+    static bool is_odd(const BigInt& x);
+};
+
+const BigDecimal operator+(const BigDecimal& lhs, const BigDecimal& rhs);
+const BigDecimal operator-(const BigDecimal& lhs, const BigDecimal& rhs);
+const BigDecimal operator*(const BigDecimal& lhs, const BigDecimal& rhs);
+std::ostream& operator<<(std::ostream& os, const BigDecimal& num);
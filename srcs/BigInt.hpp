@@ -5,9 +5,27 @@
 #include <vector>
 #include <utility>
 
+#include <srcs/BigInt_stats.hpp>
+#include <srcs/BigInt_storage.hpp>
+
 class BigInt {
  public:
     typedef unsigned int DigitType;
+#ifdef BIGINT_STATS
+    typedef std::vector<DigitType, BigIntStats::Allocator<DigitType> > PlainDigitVector;
+#else
+    typedef std::vector<DigitType> PlainDigitVector;
+#endif
+#ifdef BIGINT_HASH_CACHE
+    typedef HashedDigits<PlainDigitVector> CachedDigitVector;
+#else
+    typedef PlainDigitVector CachedDigitVector;
+#endif
+#ifdef BIGINT_COW
+    typedef SharedDigits<CachedDigitVector> DigitVector;
+#else
+    typedef CachedDigitVector DigitVector;
+#endif
     // BigInt_basic.cpp
     BigInt();
     BigInt(const BigInt& other);
@@ -32,8 +50,12 @@ class BigInt {
     BigInt& operator--();
     BigInt operator--(int);
     static BigInt pow(const BigInt& base, std::size_t exp);
+    static void divmod(const BigInt& divided, const BigInt& divisor,
+                       BigInt& quotient, BigInt& remainder);
 
     // BigInt_comparison.cpp
+    int compare(const BigInt& rhs) const;
+    int compare_abs(const BigInt& rhs) const;
     bool operator==(const BigInt& rhs) const;
     bool operator!=(const BigInt& rhs) const;
     bool operator<(const BigInt& rhs) const;
@@ -42,16 +64,75 @@ class BigInt {
     bool operator>=(const BigInt& rhs) const;
 
     // BigInt_conversion.cpp
+    // 組み込みの整数型はどれも曖昧にならずに選ばれるよう、型ごとに用意する
     explicit BigInt(int value);
+    explicit BigInt(long value);
+    explicit BigInt(long long value);
+    explicit BigInt(unsigned int value);
+    explicit BigInt(unsigned long value);
+    explicit BigInt(unsigned long long value);
+    // 0 方向に切り捨てる。NaN と無限大は std::invalid_argument
+    explicit BigInt(double value);
     explicit BigInt(const std::string& str);
     std::string toString() const;
+    // 以下は上位の limb だけを見るので toString() を作らない
+    std::size_t digitCount() const;
+    double log2Approx() const;
+    double log10Approx() const;
+    // 最近接偶数丸め。double の範囲を超えると ±無限大
+    double toDouble() const;
+    // 範囲外は std::overflow_error
+    long long toInt64() const;
+    unsigned long long toUint64() const;
+
+    // BigInt_radix.cpp
+    BigInt(const std::string& str, int base);
+    std::string toString(int base) const;
+
+    // BigInt_tuning.cpp
+    struct Thresholds {
+        std::size_t multiply;
+        std::size_t division;
+        std::size_t radix;
+    };
+    static Thresholds thresholds();
+    static Thresholds defaultThresholds();
+    // 閾値は全演算がロックなしで読む。書き換えは他のスレッドが BigInt を
+    // 使っていないとき (起動直後やベンチマークの合間) だけにすること。
+    static void setThresholds(const Thresholds& t);
+    static void resetThresholds();
+
+    // BigInt_prime.cpp
+    bool isProbablePrime() const;
+    static BigInt nextPrime(const BigInt& n);
+
+    // BigInt_hash.cpp
+    // == と整合するハッシュ値。BIGINT_HASH_CACHE なら limb 部分を覚えておき、
+    // 書き換えるまでは O(1)
+    std::size_t hash() const;
+
+    // BigInt_stream.cpp
+    static const std::size_t STREAM_CHUNK_SIZE = 1 << 16;
+    std::istream& readFrom(std::istream& is);
+    std::ostream& writeTo(std::ostream& os,
+                          std::size_t chunkSize = STREAM_CHUNK_SIZE) const;
+    void readFromFd(int fd, std::size_t chunkSize = STREAM_CHUNK_SIZE);
+    void writeToFd(int fd, std::size_t chunkSize = STREAM_CHUNK_SIZE) const;
+    std::size_t textLength() const;
 
  private:
-    std::vector<DigitType> _digits;
+    template <std::size_t N> friend class FixedBigInt;
+    friend class BigIntBatch;
+    friend class BigIntRNS;
+    friend class BigDecimal;
+
+    DigitVector _digits;
     bool _isNegative;
     static const unsigned int BASE = 1000000000;
-    static const std::size_t MULTIPLY_THRESHOLD = 10;
-    static const std::size_t DIVISION_THRESHOLD = 70;
+    // BigInt_tuning.cpp (既定値は bigint_tuning.hpp があればそこから)
+    static std::size_t MULTIPLY_THRESHOLD;
+    static std::size_t DIVISION_THRESHOLD;
+    static std::size_t RADIX_THRESHOLD;
 
     BigInt karatsuba_multiply(const BigInt& a, const BigInt& b) const;
     BigInt schoolbook_multiply(const BigInt& a, const BigInt& b) const;
@@ -76,10 +157,28 @@ class BigInt {
                         BigInt& quotient,
                         BigInt& remainder) const;
 
+    static void radix_powers(unsigned long long radix, std::size_t level,
+                             std::vector<BigInt>& powers);
+    static void to_radix_chunks(const BigInt& x,
+                                const std::vector<BigInt>& powers,
+                                std::size_t level,
+                                DigitType* out);
+    static BigInt from_radix_chunks(const DigitType* chunks,
+                                    const std::vector<BigInt>& powers,
+                                    std::size_t level);
+
+    // BigInt_prime.cpp
+    class Montgomery;
+    DigitType mod_small(DigitType m) const;
+    void small_residues(std::size_t count, PlainDigitVector& out) const;
+
     // help functions
+    static int compare_abs(const DigitType* a, std::size_t na,
+                           const DigitType* b, std::size_t nb);
     BigInt shift_block_left(std::size_t n) const;
     BigInt extract_range(std::size_t start, std::size_t end) const;
     BigInt scalar_mul(int s) const;
+    BigInt shift_bits_left(unsigned int bits) const;
     static void add_abs(BigInt& a, const BigInt& b);
     static void sub_abs(BigInt& a, const BigInt& b);
 };
@@ -98,3 +197,11 @@ const BigInt operator%(const BigInt& lhs, const BigInt& rhs);
 std::ostream& operator<<(std::ostream& os, const BigInt& num);
 std::istream& operator>>(std::istream& is, BigInt& num);
 
+// BigInt_hash.cpp
+// std::tr1::unordered_map<BigInt, T, BigIntHash> などに渡すハッシュ関数
+struct BigIntHash {
+    std::size_t operator()(const BigInt& x) const {
+        return x.hash();
+    }
+};
+
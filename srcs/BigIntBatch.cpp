@@ -0,0 +1,328 @@
+#include <stdexcept>
+#include <vector>
+
+#include <srcs/BigInt.hpp>
+#include <srcs/BigIntBatch.hpp>
+
+namespace {
+
+const unsigned int kBase = 1000000000;
+const double kInverseBase = 1.0 / kBase;
+
+// 2^31 未満の値を double に (符号付きを経由すると SIMD の変換命令が使える)
+inline double to_double(unsigned int x) {
+    return static_cast<double>(static_cast<int>(x));
+}
+
+// x / d と x % d。approx は x を double にしたもの、low は x mod 2^32、
+// inverse は 1.0 / d。商が 2^31 未満、d <= 10^9 であること。
+// 商を double で見積もると誤差は ±1 に収まるので、余りを 32 bit で求めて
+// 1 回ずつ補正する。64 bit の除算を使わないので要素方向のループが SIMD 化される。
+inline unsigned int div_estimate(double approx, unsigned int low, unsigned int d,
+                                 double inverse, unsigned int& rem) {
+    unsigned int q = static_cast<unsigned int>(static_cast<int>(approx * inverse));
+    int r = static_cast<int>(low - q * d);
+    unsigned int c = r < 0;
+    r += static_cast<int>(c * d);
+    q -= c;
+    c = r >= static_cast<int>(d);
+    r -= static_cast<int>(c * d);
+    q += c;
+    rem = static_cast<unsigned int>(r);
+    return q;
+}
+
+inline void check_index(std::size_t i, std::size_t size, const char* what) {
+    if (i >= size) {
+        throw std::out_of_range(what);
+    }
+}
+
+}  // namespace
+
+BigIntBatch::BigIntBatch(std::size_t count, std::size_t limbs)
+    : _count(count), _limbs(limbs), _data(count * limbs, 0) {}
+
+std::size_t BigIntBatch::count() const {
+    return _count;
+}
+
+std::size_t BigIntBatch::limbs() const {
+    return _limbs;
+}
+
+BigIntBatch::DigitType* BigIntBatch::row(std::size_t i) {
+    check_index(i, _limbs, "BigIntBatch: limb index out of range");
+    return _data.empty() ? 0 : &_data[0] + i * _count;
+}
+
+const BigIntBatch::DigitType* BigIntBatch::row(std::size_t i) const {
+    check_index(i, _limbs, "BigIntBatch: limb index out of range");
+    return _data.empty() ? 0 : &_data[0] + i * _count;
+}
+
+void BigIntBatch::set(std::size_t index, const BigInt& value) {
+    check_index(index, _count, "BigIntBatch: index out of range");
+    if (value.isNegative()) {
+        throw std::invalid_argument("BigIntBatch: negative value");
+    }
+    std::size_t n = value._digits.size();
+    while (n > 0 && value._digits[n - 1] == 0) {
+        --n;
+    }
+    if (n > _limbs) {
+        throw std::overflow_error("BigIntBatch: value does not fit");
+    }
+    for (std::size_t i = 0; i < _limbs; ++i) {
+        _data[i * _count + index] = i < n ? value._digits[i] : 0;
+    }
+}
+
+BigInt BigIntBatch::get(std::size_t index) const {
+    check_index(index, _count, "BigIntBatch: index out of range");
+    BigInt res;
+    res._digits.resize(_limbs > 0 ? _limbs : 1, 0);
+    DigitType* d = mutable_data(res._digits);
+    for (std::size_t i = 0; i < _limbs; ++i) {
+        d[i] = _data[i * _count + index];
+    }
+    res.normalize();
+    return res;
+}
+
+void BigIntBatch::checkCompatible(const BigIntBatch& rhs) const {
+    if (_count != rhs._count) {
+        throw std::invalid_argument("BigIntBatch: count mismatch");
+    }
+}
+
+BigIntBatch BigIntBatch::add(const BigIntBatch& rhs) const {
+    checkCompatible(rhs);
+    if (_limbs != rhs._limbs) {
+        throw std::invalid_argument("BigIntBatch: limb count mismatch");
+    }
+    BigIntBatch res(_count, _limbs + 1);
+    // 最上位の行をそのまま繰り上がりの置き場に使う
+    DigitType* carry = res.row(_limbs);
+    for (std::size_t i = 0; i < _limbs; ++i) {
+        const DigitType* a = row(i);
+        const DigitType* b = rhs.row(i);
+        DigitType* out = res.row(i);
+        for (std::size_t k = 0; k < _count; ++k) {
+            DigitType s = a[k] + b[k] + carry[k];
+            DigitType c = s >= kBase;
+            out[k] = s - c * kBase;
+            carry[k] = c;
+        }
+    }
+    return res;
+}
+
+BigIntBatch BigIntBatch::sub(const BigIntBatch& rhs) const {
+    checkCompatible(rhs);
+    if (_limbs != rhs._limbs) {
+        throw std::invalid_argument("BigIntBatch: limb count mismatch");
+    }
+    BigIntBatch res(_count, _limbs);
+    std::vector<DigitType> borrow(_count, 0);
+    for (std::size_t i = 0; i < _limbs; ++i) {
+        const DigitType* a = row(i);
+        const DigitType* b = rhs.row(i);
+        DigitType* out = res.row(i);
+        for (std::size_t k = 0; k < _count; ++k) {
+            DigitType t = b[k] + borrow[k];
+            DigitType c = a[k] < t;
+            out[k] = a[k] + c * kBase - t;
+            borrow[k] = c;
+        }
+    }
+    for (std::size_t k = 0; k < _count; ++k) {
+        if (borrow[k]) {
+            throw std::range_error("BigIntBatch: negative result in sub");
+        }
+    }
+    return res;
+}
+
+// 行ごとの積和。i 行目の乗数を全要素で同時に掛けて結果の行 i..i+nb に足す。
+BigIntBatch BigIntBatch::mul(const BigIntBatch& rhs) const {
+    checkCompatible(rhs);
+    BigIntBatch res(_count, _limbs + rhs._limbs);
+    std::vector<DigitType> carry(_count);
+    for (std::size_t i = 0; i < _limbs; ++i) {
+        const DigitType* a = row(i);
+        for (std::size_t k = 0; k < _count; ++k) {
+            carry[k] = 0;
+        }
+        for (std::size_t j = 0; j < rhs._limbs; ++j) {
+            const DigitType* b = rhs.row(j);
+            DigitType* out = res.row(i + j);
+            for (std::size_t k = 0; k < _count; ++k) {
+                // out + a * b + carry < 10^18 + 2 * 10^9 なので商は 2^31 未満
+                double approx = to_double(a[k]) * to_double(b[k])
+                    + to_double(out[k]) + to_double(carry[k]);
+                DigitType low = a[k] * b[k] + out[k] + carry[k];
+                DigitType rem;
+                carry[k] = div_estimate(approx, low, kBase, kInverseBase, rem);
+                out[k] = rem;
+            }
+        }
+        DigitType* top = res.row(i + rhs._limbs);
+        for (std::size_t k = 0; k < _count; ++k) {
+            top[k] = carry[k];
+        }
+    }
+    return res;
+}
+
+// 法が全要素で共通なので、正規化係数 d と正規化した除数は 1 回だけ作り、
+// 各桁の商推定・乗算減算・足し戻しを要素方向に並べて行う (Knuth の算法 D)。
+// 割り算はすべて div_estimate で、2^32 以上になる中間値を持たない。
+BigIntBatch BigIntBatch::mod(const BigInt& modulus) const {
+    if (modulus.isZero()) {
+        throw std::runtime_error("Division by zero");
+    }
+    if (modulus.isNegative()) {
+        throw std::invalid_argument("BigIntBatch: negative modulus");
+    }
+    std::size_t n = modulus._digits.size();
+    while (modulus._digits[n - 1] == 0) {
+        --n;
+    }
+    BigIntBatch res(_count, n);
+    if (_count == 0) {
+        return res;
+    }
+    if (_limbs < n) {
+        for (std::size_t i = 0; i < _limbs; ++i) {
+            const DigitType* a = row(i);
+            DigitType* out = res.row(i);
+            for (std::size_t k = 0; k < _count; ++k) {
+                out[k] = a[k];
+            }
+        }
+        return res;
+    }
+    if (n == 1) {
+        const DigitType d = modulus._digits[0];
+        const double inverse = 1.0 / d;
+        DigitType* out = res.row(0);
+        for (std::size_t i = _limbs; i > 0; --i) {
+            const DigitType* a = row(i - 1);
+            for (std::size_t k = 0; k < _count; ++k) {
+                DigitType r = out[k];
+                DigitType rem;
+                div_estimate(to_double(r) * kBase + to_double(a[k]), r * kBase + a[k],
+                             d, inverse, rem);
+                out[k] = rem;
+            }
+        }
+        return res;
+    }
+
+    const DigitType d = kBase / (modulus._digits[n - 1] + 1);
+    std::vector<DigitType> v(n);
+    unsigned long long vc = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        unsigned long long cur = static_cast<unsigned long long>(modulus._digits[i]) * d + vc;
+        v[i] = static_cast<DigitType>(cur % kBase);
+        vc = cur / kBase;
+    }
+    const DigitType v_top = v[n - 1];
+    const DigitType v_sec = v[n - 2];
+    const double top_inverse = 1.0 / v_top;
+
+    // u = a * d を (limbs + 1) 行の作業領域に
+    std::vector<DigitType> u((_limbs + 1) * _count);
+    std::vector<DigitType> carry(_count, 0);
+    for (std::size_t i = 0; i < _limbs; ++i) {
+        const DigitType* a = row(i);
+        DigitType* ui = &u[i * _count];
+        for (std::size_t k = 0; k < _count; ++k) {
+            DigitType rem;
+            carry[k] = div_estimate(to_double(a[k]) * d + to_double(carry[k]),
+                                    a[k] * d + carry[k], kBase, kInverseBase, rem);
+            ui[k] = rem;
+        }
+    }
+    for (std::size_t k = 0; k < _count; ++k) {
+        u[_limbs * _count + k] = carry[k];
+    }
+
+    std::vector<DigitType> q(_count);
+    std::vector<DigitType> borrow(_count);
+    std::size_t m = _limbs - n;
+    for (std::size_t j = m + 1; j-- > 0; ) {
+        const DigitType* u_top = &u[(j + n) * _count];
+        const DigitType* u_next = &u[(j + n - 1) * _count];
+        const DigitType* u_third = &u[(j + n - 2) * _count];
+        for (std::size_t k = 0; k < _count; ++k) {
+            // u_top <= v_top なので q_hat <= 10^9 + 2
+            DigitType r_hat;
+            DigitType q_hat = div_estimate(to_double(u_top[k]) * kBase + to_double(u_next[k]),
+                                           u_top[k] * kBase + u_next[k],
+                                           v_top, top_inverse, r_hat);
+            // 推定値の補正は高々 2 回。q_hat * v_sec は 10^9 進の 2 桁にして比べる
+            for (int t = 0; t < 2; ++t) {
+                DigitType lo;
+                DigitType hi = div_estimate(to_double(q_hat) * to_double(v_sec), q_hat * v_sec,
+                                            kBase, kInverseBase, lo);
+                DigitType over = (r_hat < kBase)
+                    & ((q_hat >= kBase) | (hi > r_hat) | ((hi == r_hat) & (lo > u_third[k])));
+                q_hat -= over;
+                r_hat += over * v_top;
+            }
+            q[k] = q_hat;
+            carry[k] = 0;
+            borrow[k] = 0;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            DigitType* ui = &u[(j + i) * _count];
+            const DigitType vi = v[i];
+            for (std::size_t k = 0; k < _count; ++k) {
+                DigitType lo;
+                carry[k] = div_estimate(to_double(q[k]) * to_double(vi) + to_double(carry[k]),
+                                        q[k] * vi + carry[k], kBase, kInverseBase, lo);
+                DigitType t = lo + borrow[k];
+                DigitType c = ui[k] < t;
+                ui[k] = ui[k] + c * kBase - t;
+                borrow[k] = c;
+            }
+        }
+        DigitType* un = &u[(j + n) * _count];
+        for (std::size_t k = 0; k < _count; ++k) {
+            // 負なら除数を 1 回足し戻す (要素ごとにマスク)
+            DigitType t = carry[k] + borrow[k];
+            DigitType c = un[k] < t;
+            un[k] = (un[k] - t) * (1 - c);
+            borrow[k] = c;
+            carry[k] = 0;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            DigitType* ui = &u[(j + i) * _count];
+            const DigitType vi = v[i];
+            for (std::size_t k = 0; k < _count; ++k) {
+                DigitType sum = ui[k] + borrow[k] * vi + carry[k];
+                DigitType c = sum >= kBase;
+                ui[k] = sum - c * kBase;
+                carry[k] = c;
+            }
+        }
+    }
+
+    // 余り = u[0..n) / d
+    const double d_inverse = 1.0 / d;
+    std::vector<DigitType> rem(_count, 0);
+    for (std::size_t i = n; i > 0; --i) {
+        const DigitType* ui = &u[(i - 1) * _count];
+        DigitType* out = res.row(i - 1);
+        for (std::size_t k = 0; k < _count; ++k) {
+            DigitType r = rem[k];
+            DigitType next;
+            out[k] = div_estimate(to_double(r) * kBase + to_double(ui[k]), r * kBase + ui[k],
+                                  d, d_inverse, next);
+            rem[k] = next;
+        }
+    }
+    return res;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include <srcs/BigInt.hpp>
+
+// 同じ limb 数の非負整数 count 個を limb 単位でインターリーブして持つ (SoA)。
+// i 番目の limb を全要素ぶん連続に並べるので、演算の最内ループは要素方向に
+// 分岐なしで回り、コンパイラがそのまま SIMD 化できる。
+// 値ごとの確保は無く、結果のバッチごとに 1 回だけ確保する。
+class BigIntBatch {
+ public:
+    typedef BigInt::DigitType DigitType;
+
+    BigIntBatch(std::size_t count, std::size_t limbs);
+    std::size_t count() const;
+    std::size_t limbs() const;
+    void set(std::size_t index, const BigInt& value);
+    BigInt get(std::size_t index) const;
+    // set / get / row は範囲外の添字で std::out_of_range を投げる
+    // 全要素の limb i の並び (count 個)
+    DigitType* row(std::size_t i);
+    const DigitType* row(std::size_t i) const;
+
+    // 要素ごとの演算。add の結果は limbs() + 1 limb、mul は limbs の和。
+    // sub はどれかの要素が負になると std::range_error を投げる。
+    BigIntBatch add(const BigIntBatch& rhs) const;
+    BigIntBatch sub(const BigIntBatch& rhs) const;
+    BigIntBatch mul(const BigIntBatch& rhs) const;
+    // 全要素を共通の法 modulus (> 0) で割った余り
+    BigIntBatch mod(const BigInt& modulus) const;
+
+ private:
+    std::size_t _count;
+    std::size_t _limbs;
+    std::vector<DigitType> _data;
+
+    void checkCompatible(const BigIntBatch& rhs) const;
+};
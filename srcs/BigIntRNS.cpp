@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <srcs/BigInt.hpp>
+#include <srcs/BigIntRNS.hpp>
+
+namespace {
+
+const unsigned long long kBase = 1000000000ULL;
+// 剰余の木を下りるとき、値がこの limb 数以下になったら葉ごとに直接割る
+const std::size_t kDirectLimbs = 16;
+
+unsigned long long pow_mod(unsigned long long a, unsigned long long e,
+                           unsigned long long m) {
+    unsigned long long r = 1;
+    a %= m;
+    for (; e > 0; e >>= 1) {
+        if (e & 1) {
+            r = r * a % m;
+        }
+        a = a * a % m;
+    }
+    return r;
+}
+
+// n < 2^32 なら底 2, 7, 61 の Miller-Rabin で決定的に判定できる
+bool is_prime_word(unsigned long long n) {
+    static const unsigned long long kBases[] = {2, 7, 61};
+    if (n < 2) {
+        return false;
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+        if (n % kBases[i] == 0) {
+            return n == kBases[i];
+        }
+    }
+    unsigned long long d = n - 1;
+    int s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        ++s;
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+        unsigned long long x = pow_mod(kBases[i], d, n);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        int r = 1;
+        for (; r < s; ++r) {
+            x = x * x % n;
+            if (x == n - 1) {
+                break;
+            }
+        }
+        if (r == s) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// x mod m (x < 2^62)。商の見積もりは高々 1 小さいだけなので 1 回引けば済む。
+BigIntRNS::Residue reduce_word(unsigned long long x, unsigned long long m,
+                               unsigned long long reciprocal) {
+    unsigned long long q = static_cast<unsigned long long>(
+        (static_cast<unsigned __int128>(x) * reciprocal) >> 64);
+    unsigned long long r = x - q * m;
+    return static_cast<BigIntRNS::Residue>(r >= m ? r - m : r);
+}
+
+}  // namespace
+
+BigIntRNS::Basis::Basis(std::size_t bits) {
+    // 符号の分と余裕を見て M > 2^(bits + 2) になるまで取る
+    double covered = 0;
+    for (unsigned long long p = 0x7fffffffULL; covered <= bits + 2.0; p -= 2) {
+        if (is_prime_word(p)) {
+            _moduli.push_back(static_cast<Residue>(p));
+            covered += std::log(static_cast<double>(p)) / std::log(2.0);
+        }
+    }
+    std::size_t k = _moduli.size();
+
+    _reciprocals.resize(k);
+    for (std::size_t i = 0; i < k; ++i) {
+        _reciprocals[i] = ~0ULL / _moduli[i];
+    }
+    _inverses.resize(k);
+    for (std::size_t i = 0; i < k; ++i) {
+        unsigned long long m = _moduli[i];
+        unsigned long long others = 1;
+        for (std::size_t j = 0; j < k; ++j) {
+            if (j != i) {
+                others = others * _moduli[j] % m;
+            }
+        }
+        _inverses[i] = static_cast<Residue>(pow_mod(others, m - 2, m));
+    }
+
+    _tree.push_back(std::vector<BigInt>());
+    for (std::size_t i = 0; i < k; ++i) {
+        _tree[0].push_back(BigInt(static_cast<int>(_moduli[i])));
+    }
+    while (_tree.back().size() > 1) {
+        const std::vector<BigInt>& below = _tree.back();
+        std::vector<BigInt> level;
+        for (std::size_t j = 0; j < below.size(); j += 2) {
+            level.push_back(j + 1 < below.size() ? below[j] * below[j + 1] : below[j]);
+        }
+        _tree.push_back(level);
+    }
+    _half = product() / BigInt(2);
+}
+
+std::size_t BigIntRNS::Basis::size() const {
+    return _moduli.size();
+}
+
+BigIntRNS::Residue BigIntRNS::Basis::modulus(std::size_t i) const {
+    return _moduli[i];
+}
+
+const BigInt& BigIntRNS::Basis::product() const {
+    return _tree.back()[0];
+}
+
+BigIntRNS::BigIntRNS(const Basis& basis)
+    : _basis(&basis), _residues(basis.size(), 0) {}
+
+// 剰余の木: M で割った余りを、部分積で順に割りながら葉まで下ろす
+BigIntRNS::BigIntRNS(const Basis& basis, const BigInt& value)
+    : _basis(&basis), _residues(basis.size(), 0) {
+    BigInt x = value.abs();
+    if (x >= basis.product()) {
+        x %= basis.product();
+    }
+    reduce(x, basis._tree.size() - 1, 0);
+    if (value.isNegative()) {
+        *this = -*this;
+    }
+}
+
+const BigIntRNS::Basis& BigIntRNS::basis() const {
+    return *_basis;
+}
+
+BigIntRNS::Residue BigIntRNS::residue(std::size_t i) const {
+    return _residues[i];
+}
+
+void BigIntRNS::checkCompatible(const BigIntRNS& rhs) const {
+    if (_basis != rhs._basis) {
+        throw std::invalid_argument("BigIntRNS: basis mismatch");
+    }
+}
+
+void BigIntRNS::reduce(const BigInt& x, std::size_t level, std::size_t index) {
+    std::size_t first = index << level;
+    std::size_t last = std::min(first + (static_cast<std::size_t>(1) << level),
+                                _residues.size());
+    if (level == 0 || x._digits.size() <= kDirectLimbs) {
+        // Horner 法。内側を法の方向に回すので各段が互いに独立になる
+        const Residue* m = &_basis->_moduli[0];
+        const unsigned long long* reciprocal = &_basis->_reciprocals[0];
+        for (std::size_t i = first; i < last; ++i) {
+            _residues[i] = 0;
+        }
+        for (std::size_t j = x._digits.size(); j > 0; --j) {
+            unsigned long long limb = x._digits[j - 1];
+            for (std::size_t i = first; i < last; ++i) {
+                _residues[i] = reduce_word(_residues[i] * kBase + limb, m[i], reciprocal[i]);
+            }
+        }
+        return;
+    }
+    const std::vector<BigInt>& below = _basis->_tree[level - 1];
+    std::size_t left = 2 * index;
+    if (left + 1 < below.size()) {
+        reduce(x % below[left], level - 1, left);
+        reduce(x % below[left + 1], level - 1, left + 1);
+    } else {
+        // 右の子が無い節は左の子と同じ積なので割らずに下りる
+        reduce(x, level - 1, left);
+    }
+}
+
+// 部分積の木を上りながら sum r_i c_i (P / m_i) を作る (P はその節の積)
+BigInt BigIntRNS::combine(std::size_t level, std::size_t index) const {
+    if (level == 0) {
+        Residue v = reduce_word(
+            static_cast<unsigned long long>(_residues[index]) * _basis->_inverses[index],
+            _basis->_moduli[index], _basis->_reciprocals[index]);
+        return BigInt(static_cast<int>(v));
+    }
+    const std::vector<BigInt>& below = _basis->_tree[level - 1];
+    std::size_t left = 2 * index;
+    if (left + 1 >= below.size()) {
+        return combine(level - 1, left);
+    }
+    return combine(level - 1, left) * below[left + 1]
+        + combine(level - 1, left + 1) * below[left];
+}
+
+// CRT で -M/2 < x <= M/2 の代表に戻す
+BigInt BigIntRNS::toBigInt() const {
+    BigInt x = combine(_basis->_tree.size() - 1, 0) % _basis->product();
+    if (x > _basis->_half) {
+        x -= _basis->product();
+    }
+    return x;
+}
+
+BigIntRNS& BigIntRNS::operator+=(const BigIntRNS& rhs) {
+    checkCompatible(rhs);
+    const Residue* m = &_basis->_moduli[0];
+    for (std::size_t i = 0; i < _residues.size(); ++i) {
+        Residue s = _residues[i] + rhs._residues[i];
+        _residues[i] = s - (s >= m[i]) * m[i];
+    }
+    return *this;
+}
+
+BigIntRNS& BigIntRNS::operator-=(const BigIntRNS& rhs) {
+    checkCompatible(rhs);
+    const Residue* m = &_basis->_moduli[0];
+    for (std::size_t i = 0; i < _residues.size(); ++i) {
+        Residue a = _residues[i];
+        Residue b = rhs._residues[i];
+        _residues[i] = a - b + (a < b) * m[i];
+    }
+    return *this;
+}
+
+BigIntRNS& BigIntRNS::operator*=(const BigIntRNS& rhs) {
+    checkCompatible(rhs);
+    const Residue* m = &_basis->_moduli[0];
+    const unsigned long long* reciprocal = &_basis->_reciprocals[0];
+    for (std::size_t i = 0; i < _residues.size(); ++i) {
+        _residues[i] = reduce_word(
+            static_cast<unsigned long long>(_residues[i]) * rhs._residues[i],
+            m[i], reciprocal[i]);
+    }
+    return *this;
+}
+
+BigIntRNS BigIntRNS::operator-() const {
+    BigIntRNS res(*_basis);
+    res -= *this;
+    return res;
+}
+
+bool BigIntRNS::operator==(const BigIntRNS& rhs) const {
+    checkCompatible(rhs);
+    return _residues == rhs._residues;
+}
+
+bool BigIntRNS::operator!=(const BigIntRNS& rhs) const {
+    return !(*this == rhs);
+}
+
+const BigIntRNS operator+(const BigIntRNS& lhs, const BigIntRNS& rhs) {
+    BigIntRNS result(lhs);
+    result += rhs;
+    return result;
+}
+
+const BigIntRNS operator-(const BigIntRNS& lhs, const BigIntRNS& rhs) {
+    BigIntRNS result(lhs);
+    result -= rhs;
+    return result;
+}
+
+const BigIntRNS operator*(const BigIntRNS& lhs, const BigIntRNS& rhs) {
+    BigIntRNS result(lhs);
+    result *= rhs;
+    return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include <srcs/BigInt.hpp>
+
+// 2^31 未満の素数 m_0..m_{k-1} それぞれで割った余りの組で整数を持つ
+// (residue number system)。加減乗算は余りごとに独立で繰り上がりが無く、
+// 値も伸びないので、積和の連鎖を最後まで余りのまま回してから
+// 一度だけ CRT で BigInt に戻す。
+// 表せるのは -M/2 < x <= M/2 (M は法の積) で、超えると M を法として巻き戻る。
+class BigIntRNS {
+ public:
+    typedef unsigned int Residue;
+
+    // 法の組と、変換に使う積の木 (subproduct tree) をまとめて持つ。
+    // BigIntRNS は Basis を指すだけなので、値より長く生かしておくこと。
+    class Basis {
+     public:
+        // |x| < 2^bits を表せるだけ、2^31 未満の素数を大きい順に取る
+        explicit Basis(std::size_t bits);
+        std::size_t size() const;
+        Residue modulus(std::size_t i) const;
+        const BigInt& product() const;
+
+     private:
+        friend class BigIntRNS;
+
+        std::vector<Residue> _moduli;
+        // floor(2^64 / m_i)。x < 2^62 の余りを除算なしで求める (Barrett)
+        std::vector<unsigned long long> _reciprocals;
+        // (M / m_i)^-1 mod m_i
+        std::vector<Residue> _inverses;
+        // _tree[0] が各法、_tree[l + 1][j] = _tree[l][2j] * _tree[l][2j + 1]。
+        // 最上段の 1 つが M。
+        std::vector<std::vector<BigInt> > _tree;
+        BigInt _half;
+    };
+
+    explicit BigIntRNS(const Basis& basis);
+    BigIntRNS(const Basis& basis, const BigInt& value);
+    BigInt toBigInt() const;
+    const Basis& basis() const;
+    Residue residue(std::size_t i) const;
+
+    BigIntRNS& operator+=(const BigIntRNS& rhs);
+    BigIntRNS& operator-=(const BigIntRNS& rhs);
+    BigIntRNS& operator*=(const BigIntRNS& rhs);
+    BigIntRNS operator-() const;
+    bool operator==(const BigIntRNS& rhs) const;
+    bool operator!=(const BigIntRNS& rhs) const;
+
+ private:
+    const Basis* _basis;
+    std::vector<Residue> _residues;
+
+    void checkCompatible(const BigIntRNS& rhs) const;
+    void reduce(const BigInt& x, std::size_t level, std::size_t index);
+    BigInt combine(std::size_t level, std::size_t index) const;
+};
+
+const BigIntRNS operator+(const BigIntRNS& lhs, const BigIntRNS& rhs);
+const BigIntRNS operator-(const BigIntRNS& lhs, const BigIntRNS& rhs);
+const BigIntRNS operator*(const BigIntRNS& lhs, const BigIntRNS& rhs);
@@ -32,7 +32,9 @@ void swap(BigInt& lhs, BigInt& rhs) {
 }
 
 void BigInt::normalize() {
-    while (_digits.size() > 1 && _digits[_digits.size() - 1] == 0) {
+    // 読むだけなら共有中の limb 配列を複製しないよう const で見る
+    const DigitVector& digits = _digits;
+    while (digits.size() > 1 && digits.back() == 0) {
         _digits.pop_back();
     }
     if (isZero()) {
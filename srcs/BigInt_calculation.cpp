@@ -7,6 +7,17 @@
 
 #include <srcs/BigInt.hpp>
 
+namespace {
+
+// x / BASE (x < 2^64) を除算命令なしで求める。BASE = 2^9 * 5^9 なので
+// 先に 2^9 で割り、5^9 は ceil(2^76 / 5^9) を掛けて 76 bit ずらす。
+inline unsigned long long div_base(unsigned long long x) {
+    return static_cast<unsigned long long>(
+        (static_cast<unsigned __int128>(x >> 9) * 0x89705f4136b4a6ULL) >> 76);
+}
+
+}  // namespace
+
 BigInt& BigInt::operator+=(const BigInt& rhs) {
     if (rhs.isZero()) {
         return *this;
@@ -16,40 +27,7 @@ BigInt& BigInt::operator+=(const BigInt& rhs) {
         return *this;
     }
     if (isNegative() == rhs.isNegative()) {
-        bool carry = false;
-        for (std::size_t i = 0; i < rhs._digits.size(); ++i) {
-            if (i < _digits.size()) {
-                _digits[i] += rhs._digits[i] + (carry ? 1 : 0);
-                if (_digits[i] >= BASE) {
-                    _digits[i] -= BASE;
-                    carry = true;
-                } else {
-                    carry = false;
-                }
-            } else {
-                _digits.push_back(rhs._digits[i] + (carry ? 1 : 0));
-                if (_digits[i] >= BASE) {
-                    _digits[i] -= BASE;
-                    carry = true;
-                } else {
-                    carry = false;
-                }
-            }
-        }
-        std::size_t i = rhs._digits.size();
-        while (carry && i < _digits.size()) {
-            _digits[i] += 1;
-            if (_digits[i] >= BASE) {
-                _digits[i] -= BASE;
-                carry = true;
-            } else {
-                carry = false;
-            }
-            ++i;
-        }
-        if (carry) {
-            _digits.push_back(1);
-        }
+        add_abs(*this, rhs);
     } else {
         if (!isNegative()) {
             *this -= (-rhs);
@@ -74,33 +52,12 @@ BigInt& BigInt::operator-=(const BigInt& rhs) {
     if (isNegative() != rhs.isNegative()) {
         *this += -rhs;
     } else {
-        if ((!isNegative() && *this < rhs) || (isNegative() && *this > rhs)) {
+        if (compare_abs(rhs) < 0) {
             BigInt temp = rhs;
             temp -= *this;
             *this = -temp;
         } else {
-            bool borrow = false;
-            for (std::size_t i = 0; i < rhs._digits.size(); ++i) {
-                DigitType rhsDigit = rhs._digits[i] + (borrow ? 1 : 0);
-                if (_digits[i] < rhsDigit) {
-                    borrow = true;
-                    _digits[i] += BASE;
-                } else {
-                    borrow = false;
-                }
-                _digits[i] -= rhsDigit;
-            }
-            std::size_t i = rhs._digits.size();
-            while (borrow && i < _digits.size()) {
-                if (_digits[i] == 0) {
-                    _digits[i] = BASE - 1;
-                    borrow = true;
-                } else {
-                    _digits[i] -= 1;
-                    borrow = false;
-                }
-                ++i;
-            }
+            sub_abs(*this, rhs);
         }
     }
     normalize();
@@ -187,11 +144,13 @@ const BigInt operator%(const BigInt& lhs, const BigInt& rhs) {
 }
 
 BigInt BigInt::shift_block_left(std::size_t n) const {
-    BigInt res = *this;
     if (isZero() || n == 0) {
-        return res;
+        return *this;
     }
-    res._digits.insert(res._digits.begin(), n, 0);
+    BigInt res;
+    res._digits.resize(n + _digits.size(), 0);
+    std::copy(_digits.begin(), _digits.end(), mutable_data(res._digits) + n);
+    res._isNegative = _isNegative;
     return res;
 }
 
@@ -207,15 +166,33 @@ BigInt BigInt::extract_range(std::size_t start, std::size_t end) const {
 }
 
 
+// 2^bits 倍 (bits < 30)
+BigInt BigInt::shift_bits_left(unsigned int bits) const {
+    BigInt res;
+    res._digits.resize(_digits.size());
+    DigitType* r = mutable_data(res._digits);
+    unsigned long long carry = 0;
+    for (std::size_t i = 0; i < _digits.size(); ++i) {
+        unsigned long long cur = (static_cast<unsigned long long>(_digits[i]) << bits) + carry;
+        carry = div_base(cur);
+        r[i] = static_cast<DigitType>(cur - carry * BASE);
+    }
+    if (carry) res._digits.push_back(static_cast<DigitType>(carry));
+    res._isNegative = _isNegative;
+    res.normalize();
+    return res;
+}
+
 BigInt BigInt::scalar_mul(int s) const {
     if (s == 1) return *this;
     if (s == 0) return BigInt(0);
     BigInt res;
     res._digits.resize(_digits.size());
+    DigitType* r = mutable_data(res._digits);
     long long carry = 0;
     for (std::size_t i = 0; i < _digits.size(); ++i) {
         long long cur = (long long)_digits[i] * s + carry;
-        res._digits[i] = cur % BASE;
+        r[i] = cur % BASE;
         carry = cur / BASE;
     }
     if (carry) res._digits.push_back(carry);
@@ -223,36 +200,62 @@ BigInt BigInt::scalar_mul(int s) const {
     return res;
 }
 
+// |a| += |b|。a と b は同じオブジェクトでもよい
 void BigInt::add_abs(BigInt& a, const BigInt& b) {
-    if (a._digits.size() < b._digits.size()) {
-        a._digits.resize(b._digits.size(), 0);
+    std::size_t nb = b._digits.size();
+    if (a._digits.size() < nb) {
+        a._digits.resize(nb, 0);
+    }
+    // 書き込み先を先に取り、b が a 自身でも同じ配列を読むようにする
+    DigitType* d = mutable_data(a._digits);
+    const DigitType* s = nb > 0 ? &b._digits[0] : 0;
+    bool carry = false;
+    for (std::size_t i = 0; i < nb; ++i) {
+        d[i] += s[i] + (carry ? 1 : 0);
+        if (d[i] >= BASE) {
+            d[i] -= BASE;
+            carry = true;
+        } else {
+            carry = false;
+        }
     }
-    long long carry = 0;
-    for (size_t i = 0; i < b._digits.size() || carry; ++i) {
-        if (i == a._digits.size()) a._digits.push_back(0);
-        long long sum = carry + a._digits[i] + (i < b._digits.size() ? b._digits[i] : 0);
-        if (sum >= BASE) {
-            sum -= BASE;
-            carry = 1;
+    for (std::size_t i = nb; carry && i < a._digits.size(); ++i) {
+        d[i] += 1;
+        if (d[i] >= BASE) {
+            d[i] -= BASE;
         } else {
-            carry = 0;
+            carry = false;
         }
-        a._digits[i] = sum;
+    }
+    if (carry) {
+        a._digits.push_back(1);
     }
     a.normalize();
 }
 
+// |a| -= |b| (|a| >= |b|)。a と b は同じオブジェクトでもよい
 void BigInt::sub_abs(BigInt& a, const BigInt& b) {
-    long long borrow = 0;
-    for (size_t i = 0; i < b._digits.size() || borrow; ++i) {
-        long long sub = a._digits[i] - borrow - (i < b._digits.size() ? b._digits[i] : 0);
-        if (sub < 0) {
-            sub += BASE;
-            borrow = 1;
+    std::size_t nb = b._digits.size();
+    DigitType* d = mutable_data(a._digits);
+    const DigitType* s = nb > 0 ? &b._digits[0] : 0;
+    bool borrow = false;
+    for (std::size_t i = 0; i < nb; ++i) {
+        DigitType sub = s[i] + (borrow ? 1 : 0);
+        if (d[i] < sub) {
+            borrow = true;
+            d[i] += BASE;
         } else {
-            borrow = 0;
+            borrow = false;
+        }
+        d[i] -= sub;
+    }
+    for (std::size_t i = nb; borrow; ++i) {
+        if (d[i] == 0) {
+            d[i] = BASE - 1;
+        } else {
+            d[i] -= 1;
+            borrow = false;
         }
-        a._digits[i] = sub;
     }
     a.normalize();
 }
@@ -267,6 +270,7 @@ BigInt BigInt::karatsuba_multiply(const BigInt& a, const BigInt& b) const {
     if (a._digits.size() < MULTIPLY_THRESHOLD || b._digits.size() < MULTIPLY_THRESHOLD) {
         return schoolbook_multiply(a, b);
     }
+    BIGINT_STATS_SCOPE(KARATSUBA_MULTIPLY, std::max(a._digits.size(), b._digits.size()));
 
     std::size_t n = std::max(a._digits.size(), b._digits.size());
     std::size_t m = (n + 1) / 2;
@@ -296,19 +300,24 @@ BigInt BigInt::karatsuba_multiply(const BigInt& a, const BigInt& b) const {
 
 BigInt BigInt::schoolbook_multiply(const BigInt& a, const BigInt& b) const {
     if (a.isZero() || b.isZero()) return BigInt(0);
+    BIGINT_STATS_SCOPE(SCHOOLBOOK_MULTIPLY, std::max(a._digits.size(), b._digits.size()));
     
+    std::size_t na = a._digits.size();
+    std::size_t nb = b._digits.size();
     BigInt res;
-    res._digits.resize(a._digits.size() + b._digits.size(), 0);
+    res._digits.resize(na + nb, 0);
+    DigitType* r = mutable_data(res._digits);
+    const DigitType* x = &a._digits[0];
+    const DigitType* y = &b._digits[0];
 
-    for (std::size_t i = 0; i < a._digits.size(); ++i) {
+    for (std::size_t i = 0; i < na; ++i) {
         long long carry = 0;
-        for (std::size_t j = 0; j < b._digits.size(); ++j) {
-            long long cur = res._digits[i + j] + 
-                            (long long)a._digits[i] * b._digits[j] + carry;
-            res._digits[i + j] = cur % BASE;
+        for (std::size_t j = 0; j < nb; ++j) {
+            long long cur = r[i + j] + (long long)x[i] * y[j] + carry;
+            r[i + j] = cur % BASE;
             carry = cur / BASE;
         }
-        res._digits[i + b._digits.size()] += carry;
+        r[i + nb] += carry;
     }
     res._isNegative = (a._isNegative != b._isNegative);
     res.normalize();
@@ -324,32 +333,44 @@ void BigInt::division_and_remainder(const BigInt& divided,
                                 BigInt& quotient,
                                 BigInt& remainder) const {
     if (divisor.isZero()) throw std::runtime_error("Division by zero");
+    BIGINT_STATS_SCOPE(DIVISION, divided._digits.size());
     
-    BigInt u = divided.abs();
-    BigInt v = divisor.abs();
-
-    if (u < v) {
+    if (divided.compare_abs(divisor) < 0) {
         quotient = BigInt(0);
         remainder = divided;
         return;
     }
-    
-    int v_top = v._digits.back();
-    int d = BASE / (v_top + 1);
-    
-    if (d > 1) {
-        u = u.scalar_mul(d);
-        v = v.scalar_mul(d);
+
+    BigInt u = divided.abs();
+    BigInt v = divisor.abs();
+
+    // 除数の最上位 limb が BASE / 2 以上になるよう 2^shift 倍する。
+    // 2 の冪なので、余りを戻すのはシフトとマスクで済む。
+    unsigned int shift = 0;
+    while ((static_cast<unsigned long long>(v._digits.back()) << (shift + 1)) < BASE) {
+        ++shift;
+    }
+    if (shift > 0) {
+        BigInt v_shifted = v.shift_bits_left(shift);
+        if (v_shifted._digits.size() > v._digits.size()) {
+            // 下位からの繰り上がりで桁が増えたら 1 bit 戻す
+            --shift;
+            v_shifted = v.shift_bits_left(shift);
+        }
+        v.swap(v_shifted);
+        u = u.shift_bits_left(shift);
     }
 
     recursive_division(u, v, quotient, remainder);
 
-    if (d > 1) {
-        long long rem = 0;
-        for (int i = remainder._digits.size() - 1; i >= 0; --i) {
-            long long cur = remainder._digits[i] + rem * BASE;
-            remainder._digits[i] = cur / d;
-            rem = cur % d;
+    if (shift > 0) {
+        unsigned long long mask = (1ULL << shift) - 1;
+        unsigned long long rem = 0;
+        DigitType* d = mutable_data(remainder._digits);
+        for (std::size_t i = remainder._digits.size(); i > 0; --i) {
+            unsigned long long cur = rem * BASE + d[i - 1];
+            d[i - 1] = static_cast<DigitType>(cur >> shift);
+            rem = cur & mask;
         }
         remainder.normalize();
     }
@@ -365,7 +386,8 @@ void BigInt::division_and_remainder(const BigInt& divided,
 }
 
 void BigInt::schoolbook_division(const BigInt& u_in, const BigInt& v_in, BigInt& q, BigInt& r) const {
-    if (u_in < v_in) {
+    BIGINT_STATS_SCOPE(SCHOOLBOOK_DIVISION, u_in._digits.size());
+    if (u_in.compare_abs(v_in) < 0) {
         q = BigInt(0);
         r = u_in;
         return;
@@ -375,61 +397,63 @@ void BigInt::schoolbook_division(const BigInt& u_in, const BigInt& v_in, BigInt&
     std::size_t m = u_in._digits.size() - n;
     
     q._digits.assign(m + 1, 0);
-    std::vector<DigitType> u = u_in._digits;
-    u.push_back(0);
-    
-    long long v_top = v_in._digits.back();
-    long long v_sec = (n > 1) ? v_in._digits[n - 2] : 0;
-
-    for (int j = m; j >= 0; --j) {
-        long long r_high = u[j + n];
-        long long r_low = u[j + n - 1];
-        unsigned __int128 dividend = ((unsigned __int128)r_high * BASE) + r_low;
-        
-        long long q_hat = dividend / v_top;
-        long long r_hat = dividend % v_top;
-
-        while (q_hat >= BASE || 
-               (unsigned __int128)q_hat * v_sec > (unsigned __int128)r_hat * BASE + ((n > 1) ? u[j + n - 2] : 0)) {
+    DigitType* q_digits = mutable_data(q._digits);
+    DigitVector u_digits = u_in._digits;
+    u_digits.push_back(0);
+    DigitType* u = mutable_data(u_digits);
+    const DigitType* v = &v_in._digits[0];
+    unsigned long long v_top = v[n - 1];
+    unsigned long long v_sec = (n > 1) ? v[n - 2] : 0;
+    // 上位 limb の逆数 ceil(2^(60 + l) / v_top) (l は v_top の bit 長)。
+    // 2 limb (< 2^60) を v_top で割った商が乗算とシフトだけで厳密に出る。
+    unsigned int v_shift = 60;
+    for (unsigned long long t = v_top; t > 0; t >>= 1) {
+        ++v_shift;
+    }
+    unsigned long long v_recip = static_cast<unsigned long long>(
+        ((static_cast<unsigned __int128>(1) << v_shift) - 1) / v_top + 1);
+
+    for (std::size_t j = m + 1; j-- > 0; ) {
+        unsigned long long dividend = u[j + n] * static_cast<unsigned long long>(BASE) + u[j + n - 1];
+        unsigned long long q_hat = static_cast<unsigned long long>(
+            (static_cast<unsigned __int128>(dividend) * v_recip) >> v_shift);
+        unsigned long long r_hat = dividend - q_hat * v_top;
+        unsigned long long u_third = (n > 1) ? u[j + n - 2] : 0;
+
+        // 除数の上位 2 limb で 3-by-2 の商まで詰める
+        while (q_hat >= BASE || q_hat * v_sec > r_hat * BASE + u_third) {
             q_hat--;
             r_hat += v_top;
             if (r_hat >= BASE) break;
         }
 
+        unsigned long long carry = 0;
         long long borrow = 0;
-        long long carry = 0;
-        for (size_t i = 0; i < n; ++i) {
-            unsigned __int128 prod = (unsigned __int128)q_hat * v_in._digits[i] + carry;
-            int prod_digit = prod % BASE;
-            carry = prod / BASE;
-
-            long long sub = (long long)u[j + i] - prod_digit - borrow;
-            if (sub < 0) {
-                sub += BASE;
-                borrow = 1;
-            } else {
-                borrow = 0;
-            }
-            u[j + i] = sub;
+        for (std::size_t i = 0; i < n; ++i) {
+            unsigned long long prod = q_hat * v[i] + carry;
+            carry = div_base(prod);
+            long long sub = static_cast<long long>(u[j + i])
+                - static_cast<long long>(prod - carry * BASE) - borrow;
+            borrow = sub < 0;
+            u[j + i] = static_cast<DigitType>(sub + borrow * BASE);
         }
-        
-        long long sub = u[j + n] - carry - borrow;
-        u[j + n] = sub;
 
-        if (sub < 0) {
+        long long top = static_cast<long long>(u[j + n]) - static_cast<long long>(carry) - borrow;
+        if (top < 0) {
             q_hat--;
-            long long add_carry = 0;
-            for (size_t i = 0; i < n; ++i) {
-                long long sum = u[j + i] + v_in._digits[i] + add_carry;
-                u[j + i] = sum % BASE;
-                add_carry = sum / BASE;
+            unsigned long long add_carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                unsigned long long sum = u[j + i] + v[i] + add_carry;
+                add_carry = sum >= BASE;
+                u[j + i] = static_cast<DigitType>(sum - add_carry * BASE);
             }
-            u[j + n] += add_carry;
+            top += static_cast<long long>(add_carry);
         }
-        q._digits[j] = q_hat;
+        u[j + n] = static_cast<DigitType>(top);
+        q_digits[j] = static_cast<DigitType>(q_hat);
     }
     q.normalize();
-    r._digits = u;
+    r._digits.swap(u_digits);
     r.normalize();
 }
 
@@ -441,11 +465,21 @@ void BigInt::recursive_division(const BigInt& a, const BigInt& b, BigInt& q, Big
         schoolbook_division(a, b, q, r);
         return;
     }
-    
-    if (n % 2 != 0) {
-        schoolbook_division(a, b, q, r);
+
+    // 除数の limb 数を j * 2^t (j <= DIVISION_THRESHOLD) に揃えておくと、
+    // divide_2n_by_n の各段で常に偶数に半分割できる。
+    std::size_t block = 1;
+    while (block * DIVISION_THRESHOLD <= n) {
+        block <<= 1;
+    }
+    std::size_t sigma = (n + block - 1) / block * block - n;
+    if (sigma > 0) {
+        BigInt r_shifted;
+        recursive_division(a.shift_block_left(sigma), b.shift_block_left(sigma), q, r_shifted);
+        r = r_shifted.extract_range(sigma, r_shifted._digits.size());
         return;
     }
+    BIGINT_STATS_SCOPE(BURNIKEL_ZIEGLER, n);
     q._digits.clear();
     r = BigInt(0);
     
@@ -480,6 +514,12 @@ void BigInt::recursive_division(const BigInt& a, const BigInt& b, BigInt& q, Big
 
 void BigInt::divide_2n_by_n(const BigInt& a, const BigInt& b, BigInt& q, BigInt& r) const {
     std::size_t n = b._digits.size();
+    BIGINT_STATS_COUNT(DIVIDE_2N_BY_N, n);
+    if (n % 2 != 0 || n < DIVISION_THRESHOLD) {
+        BIGINT_STATS_COUNT(BZ_SCHOOLBOOK_FALLBACK, n);
+        schoolbook_division(a, b, q, r);
+        return;
+    }
     std::size_t k = n / 2;
 
     BigInt a_high = a.extract_range(2 * k, a._digits.size());
@@ -508,34 +548,31 @@ void BigInt::divide_3n_by_2n(const BigInt& divided, const BigInt& divisor, BigIn
     std::size_t n = divisor._digits.size(); // 2k
     std::size_t k = n / 2;
     
-    BigInt a1 = divided.extract_range(k, divided._digits.size());
-    BigInt a2 = divided.extract_range(0, k);
+    BigInt a1 = divided.extract_range(2 * k, divided._digits.size());
+    BigInt a12 = divided.extract_range(k, divided._digits.size());
+    BigInt a3 = divided.extract_range(0, k);
     
     BigInt b1 = divisor.extract_range(k, n);
     BigInt b2 = divisor.extract_range(0, k);
 
     BigInt q_hat, r1;
     
-    if (a1 < b1) {
-        divide_2n_by_n(a1, b1, q_hat, r1);
+    if (a1.compare_abs(b1) < 0) {
+        divide_2n_by_n(a12, b1, q_hat, r1);
     } else {
-        schoolbook_division(a1, b1, q_hat, r1);
+        // a1 == b1: q_hat = BASE^k - 1, r1 = [a1, a2] - q_hat * b1
+        q_hat._digits.assign(k, BASE - 1);
+        r1 = a12;
+        r1 -= b1.shift_block_left(k);
+        r1 += b1;
     }
 
     BigInt d = karatsuba_multiply(q_hat, b2);
     
-    BigInt r_temp = r1.shift_block_left(k);
-    add_abs(r_temp, a2);
-    sub_abs(r_temp, d);
-
-    while (r_temp._isNegative) {
-        sub_abs(q_hat, BigInt(1));
-        add_abs(r_temp, divisor);
-    }
     BigInt r_curr = r1.shift_block_left(k);
-    add_abs(r_curr, a2);
+    add_abs(r_curr, a3);
     
-    while (r_curr < d) {
+    while (r_curr.compare_abs(d) < 0) {
         sub_abs(q_hat, BigInt(1));
         add_abs(r_curr, divisor);
     }
@@ -563,4 +600,9 @@ BigInt BigInt::pow(const BigInt& base, std::size_t exp) {
         current_exp >>= 1;
     }
     return result;
-}
\ No newline at end of file
+}
+
+void BigInt::divmod(const BigInt& divided, const BigInt& divisor,
+                    BigInt& quotient, BigInt& remainder) {
+    divided.division_and_remainder(divided, divisor, quotient, remainder);
+}
@@ -5,60 +5,63 @@
 
 #include <srcs/BigInt.hpp>
 
-bool BigInt::operator==(const BigInt& rhs) const {
-    if (isNegative() != rhs.isNegative()) {
-        return false;
+// 上位の 0 limb を無視して絶対値を一度だけ走査する。戻り値は -1/0/1
+int BigInt::compare_abs(const DigitType* a, std::size_t na,
+                        const DigitType* b, std::size_t nb) {
+    while (na > 0 && a[na - 1] == 0) {
+        --na;
+    }
+    while (nb > 0 && b[nb - 1] == 0) {
+        --nb;
     }
-    if (_digits.size() != rhs._digits.size()) {
-        return false;
+    if (na != nb) {
+        return na < nb ? -1 : 1;
     }
-    for (int i = _digits.size() - 1; i >= 0; --i) {
-        if (_digits[i] != rhs._digits[i]) {
-            return false;
+    // 同じ limb 配列 (コピーや COW で共有したもの) なら走査しない
+    if (a == b) {
+        return 0;
+    }
+    for (std::size_t i = na; i > 0; --i) {
+        if (a[i - 1] != b[i - 1]) {
+            return a[i - 1] < b[i - 1] ? -1 : 1;
         }
     }
-    return true;
+    return 0;
 }
 
-bool BigInt::operator!=(const BigInt& rhs) const {
-    return !(*this == rhs);
+int BigInt::compare_abs(const BigInt& rhs) const {
+    return compare_abs(_digits.empty() ? 0 : &_digits[0], _digits.size(),
+                       rhs._digits.empty() ? 0 : &rhs._digits[0], rhs._digits.size());
 }
 
-bool BigInt::operator<(const BigInt& rhs) const {
+int BigInt::compare(const BigInt& rhs) const {
     if (isNegative() != rhs.isNegative()) {
-        return isNegative();
-    }
-    if (isNegative()) {
-        if (_digits.size() != rhs._digits.size()) {
-            return _digits.size() > rhs._digits.size();
-        }
-        for (int i = _digits.size() - 1; i >= 0; --i) {
-            if (_digits[i] != rhs._digits[i]) {
-                return _digits[i] > rhs._digits[i];
-            }
-        }
-        return false;
-    } else {
-        if (_digits.size() != rhs._digits.size()) {
-            return _digits.size() < rhs._digits.size();
-        }
-        for (int i = _digits.size() - 1; i >= 0; --i) {
-            if (_digits[i] != rhs._digits[i]) {
-                return _digits[i] < rhs._digits[i];
-            }
-        }
-        return false;
+        return isNegative() ? -1 : 1;
     }
+    int c = compare_abs(rhs);
+    return isNegative() ? -c : c;
+}
+
+bool BigInt::operator==(const BigInt& rhs) const {
+    return compare(rhs) == 0;
+}
+
+bool BigInt::operator!=(const BigInt& rhs) const {
+    return compare(rhs) != 0;
+}
+
+bool BigInt::operator<(const BigInt& rhs) const {
+    return compare(rhs) < 0;
 }
 
 bool BigInt::operator<=(const BigInt& rhs) const {
-    return (*this < rhs) || (*this == rhs);
+    return compare(rhs) <= 0;
 }
 
 bool BigInt::operator>(const BigInt& rhs) const {
-    return !(*this <= rhs);
+    return compare(rhs) > 0;
 }
 
 bool BigInt::operator>=(const BigInt& rhs) const {
-    return !(*this < rhs);
+    return compare(rhs) >= 0;
 }
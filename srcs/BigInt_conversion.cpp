@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip> // std::setw, std::setfill のため
+#include <limits>
 #include <sstream> // std::stringstream のため
 #include <stdexcept>
 #include <string>
@@ -20,6 +22,51 @@ int parse_substring_with_stream(const std::string& str, std::size_t start, std::
     return val;
 }
 
+const unsigned long long kBase = 1000000000ULL;
+// 10^315 > double の最大値なので、これより limb が多ければ double では無限大
+const std::size_t kMaxDoubleLimbs = 35;
+// 10^315 < 2^1056 を 2^32 進で持てる語数
+const std::size_t kBinaryWords = 33;
+
+void assign_u64(BigInt::DigitVector& digits, unsigned long long v) {
+    if (v == 0) {
+        digits.push_back(0);
+    }
+    for (; v > 0; v /= kBase) {
+        digits.push_back(static_cast<BigInt::DigitType>(v % kBase));
+    }
+}
+
+// LLONG_MIN でも溢れない絶対値
+unsigned long long magnitude_of(long long v) {
+    unsigned long long m = static_cast<unsigned long long>(v);
+    return v < 0 ? 0 - m : m;
+}
+
+// 絶対値が 2^64 未満なら out に入れて true
+bool magnitude_u64(const BigInt::DigitVector& digits, unsigned long long& out) {
+    if (digits.size() > 3) {
+        return false;
+    }
+    unsigned long long v = 0;
+    for (std::size_t j = digits.size(); j > 0; --j) {
+        if (v > (std::numeric_limits<unsigned long long>::max() - digits[j - 1]) / kBase) {
+            return false;
+        }
+        v = v * kBase + digits[j - 1];
+    }
+    out = v;
+    return true;
+}
+
+int bit_length(unsigned int w) {
+    int bits = 0;
+    for (; w > 0; w >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
 }  // namespace
 
 BigInt::BigInt(int value)
@@ -50,11 +97,74 @@ BigInt::BigInt(int value)
     }
 }
 
+BigInt::BigInt(long long value)
+    : _digits(), _isNegative(value < 0) {
+    assign_u64(_digits, magnitude_of(value));
+}
+
+BigInt::BigInt(long value)
+    : _digits(), _isNegative(value < 0) {
+    assign_u64(_digits, magnitude_of(value));
+}
+
+BigInt::BigInt(unsigned int value)
+    : _digits(), _isNegative(false) {
+    assign_u64(_digits, value);
+}
+
+BigInt::BigInt(unsigned long value)
+    : _digits(), _isNegative(false) {
+    assign_u64(_digits, value);
+}
+
+BigInt::BigInt(unsigned long long value)
+    : _digits(), _isNegative(false) {
+    assign_u64(_digits, value);
+}
+
+BigInt::BigInt(double value)
+    : _digits(), _isNegative(false) {
+    if (value != value || value - value != 0) {
+        throw std::invalid_argument("Invalid double for BigInt: NaN or infinity");
+    }
+    double magnitude = std::fabs(value);
+    if (magnitude < 18446744073709551616.0) {
+        assign_u64(_digits, static_cast<unsigned long long>(magnitude));
+    } else {
+        // magnitude = mantissa * 2^shift を 2^32 進の語に置き、1e9 で割りながら limb を取る
+        int exp;
+        unsigned long long mantissa = static_cast<unsigned long long>(
+            std::ldexp(std::frexp(magnitude, &exp), 53));
+        std::size_t shift = static_cast<std::size_t>(exp - 53);
+        std::size_t w = shift / 32;
+        std::size_t off = shift % 32;
+        unsigned int words[kBinaryWords] = {0};
+        words[w] = static_cast<unsigned int>(mantissa << off);
+        words[w + 1] = static_cast<unsigned int>(mantissa >> (32 - off));
+        words[w + 2] = off > 0 ? static_cast<unsigned int>(mantissa >> (64 - off)) : 0;
+        for (std::size_t used = w + 3; used > 0; ) {
+            unsigned long long rem = 0;
+            for (std::size_t i = used; i-- > 0; ) {
+                unsigned long long cur = (rem << 32) | words[i];
+                words[i] = static_cast<unsigned int>(cur / kBase);
+                rem = cur % kBase;
+            }
+            _digits.push_back(static_cast<DigitType>(rem));
+            while (used > 0 && words[used - 1] == 0) {
+                --used;
+            }
+        }
+    }
+    _isNegative = value < 0;
+    normalize();
+}
+
 BigInt::BigInt(const std::string& str)
     : _digits(), _isNegative(false) {
     if (str.empty()) {
         throw std::invalid_argument("Invalid string for BigInt: empty string");
     }
+    BIGINT_STATS_SCOPE(PARSE, str.size() / 9);
 
     std::size_t startIndex = 0;
     if (str[0] == '-') {
@@ -74,14 +184,10 @@ BigInt::BigInt(const std::string& str)
     while (startIndex < str.size() - 1 && str[startIndex] == '0') {
         startIndex++;
     }
-    for (int i = (int)str.size(); i > (int)startIndex; i -= 9) {
-        int start = i - 9;
-        int len = 9;
-        if (start < (int)startIndex) {
-            len = i - startIndex;
-            start = startIndex;
-        }
-        _digits.push_back(parse_substring_with_stream(str, start, len));
+    for (std::size_t i = str.size(); i > startIndex; ) {
+        std::size_t start = i - startIndex > 9 ? i - 9 : startIndex;
+        _digits.push_back(parse_substring_with_stream(str, start, i - start));
+        i = start;
     }
     if (_digits.empty()) {
         _digits.push_back(0);
@@ -94,31 +200,116 @@ std::string BigInt::toString() const {
     if (isZero()) {
         return "0";
     }
+    BIGINT_STATS_SCOPE(TO_STRING, _digits.size());
     std::ostringstream oss;
     if (_isNegative) {
         oss << '-';
     }
     oss << _digits.back();
-    for (int i = (int)_digits.size() - 2; i >= 0; --i) {
-        oss << std::setw(9) << std::setfill('0') << _digits[i];
+    for (std::size_t i = _digits.size() - 1; i > 0; --i) {
+        oss << std::setw(9) << std::setfill('0') << _digits[i - 1];
     }
     return oss.str();
 }
 
-std::istream& operator>>(std::istream& is, BigInt& bigint) {
-    std::string str;
-    is >> str;
-    if (is) {
-        try {
-            bigint = BigInt(str);
-        } catch (...) {
-            is.setstate(std::ios::failbit);
+std::size_t BigInt::digitCount() const {
+    return textLength() - (_isNegative && !isZero() ? 1 : 0);
+}
+
+double BigInt::log2Approx() const {
+    return log10Approx() / std::log10(2.0);
+}
+
+// |x| の常用対数。上位 3 limb (27 桁) を double にして残りの limb 数を足す
+double BigInt::log10Approx() const {
+    if (isZero()) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    std::size_t n = _digits.size();
+    std::size_t k = n < 3 ? n : 3;
+    double top = 0;
+    for (std::size_t j = n; j > n - k; --j) {
+        top = top * BASE + _digits[j - 1];
+    }
+    return std::log10(top) + 9.0 * static_cast<double>(n - k);
+}
+
+// 2^32 進に直して上位 64 bit と、その下が 0 でないか (sticky) から丸める
+double BigInt::toDouble() const {
+    double sign = _isNegative ? -1.0 : 1.0;
+    std::size_t n = _digits.size();
+    if (n > kMaxDoubleLimbs) {
+        return sign * std::numeric_limits<double>::infinity();
+    }
+    unsigned long long small;
+    if (n <= 2 && magnitude_u64(_digits, small)) {
+        return sign * static_cast<double>(small);
+    }
+    unsigned int words[kBinaryWords] = {0};
+    std::size_t used = 0;
+    for (std::size_t j = n; j > 0; --j) {
+        unsigned long long carry = _digits[j - 1];
+        for (std::size_t i = 0; i < used; ++i) {
+            unsigned long long cur = static_cast<unsigned long long>(words[i]) * BASE + carry;
+            words[i] = static_cast<unsigned int>(cur);
+            carry = cur >> 32;
         }
+        if (carry > 0) {
+            words[used++] = static_cast<unsigned int>(carry);
+        }
+    }
+    // n >= 3 なので 2^59 以上あり、上位 64 bit が取れる
+    std::size_t bits = 32 * (used - 1) + bit_length(words[used - 1]);
+    if (bits <= 64) {
+        unsigned long long v = words[0] | (static_cast<unsigned long long>(words[1]) << 32);
+        return sign * static_cast<double>(v);
+    }
+    std::size_t low = bits - 64;
+    std::size_t w = low / 32;
+    std::size_t off = low % 32;
+    unsigned long long top = (static_cast<unsigned long long>(words[w]) >> off)
+        | (static_cast<unsigned long long>(words[w + 1]) << (32 - off));
+    if (off > 0) {
+        top |= static_cast<unsigned long long>(words[w + 2]) << (64 - off);
+    }
+    bool sticky = (words[w] & ((1U << off) - 1)) != 0;
+    for (std::size_t i = 0; i < w && !sticky; ++i) {
+        sticky = words[i] != 0;
+    }
+    // 53 bit に最近接偶数丸め。繰り上がって 2^53 になっても ldexp がそのまま扱う
+    unsigned long long mantissa = top >> 11;
+    unsigned long long rest = top & 0x7ff;
+    if (rest > 0x400 || (rest == 0x400 && (sticky || (mantissa & 1)))) {
+        ++mantissa;
     }
-    return is;
+    return sign * std::ldexp(static_cast<double>(mantissa), static_cast<int>(low + 11));
+}
+
+long long BigInt::toInt64() const {
+    unsigned long long magnitude;
+    const unsigned long long limit = static_cast<unsigned long long>(
+        std::numeric_limits<long long>::max());
+    if (!magnitude_u64(_digits, magnitude) || magnitude > limit + (_isNegative ? 1 : 0)) {
+        throw std::overflow_error("BigInt does not fit in a 64-bit signed integer");
+    }
+    if (_isNegative) {
+        return magnitude == 0 ? 0 : -static_cast<long long>(magnitude - 1) - 1;
+    }
+    return static_cast<long long>(magnitude);
+}
+
+unsigned long long BigInt::toUint64() const {
+    unsigned long long magnitude;
+    if ((_isNegative && !isZero()) || !magnitude_u64(_digits, magnitude)) {
+        throw std::overflow_error("BigInt does not fit in a 64-bit unsigned integer");
+    }
+    return magnitude;
+}
+
+std::istream& operator>>(std::istream& is, BigInt& bigint) {
+    return bigint.readFrom(is);
 }
 
 std::ostream& operator<<(std::ostream& os, const BigInt& num) {
-    os << num.toString();
-    return os;
-}
\ No newline at end of file
+    return num.writeTo(os);
+}
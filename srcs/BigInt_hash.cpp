@@ -0,0 +1,64 @@
+#include <cstddef>
+
+#include <srcs/BigInt.hpp>
+
+namespace {
+
+// 隣り合う 2 limb に位置ごとの鍵を足して 32x32 -> 64 bit で掛け、足し合わせる (NH)。
+// 鍵は 2^31 未満の奇数なので limb (< 10^9) と足しても 32 bit に収まり 0 にならず、
+// 積が消えて片方の limb が効かなくなることが無い。
+// 項が互いに独立なので pmuludq などでベクトル化される。
+unsigned long long hash_limbs(const BigInt::DigitType* d, std::size_t n) {
+    unsigned long long sum = 0;
+    std::size_t pairs = n / 2;
+    for (std::size_t i = 0; i < pairs; ++i) {
+        unsigned int k = static_cast<unsigned int>(i) * 0x9e3779b9U;
+        unsigned int a = d[2 * i] + ((k >> 1) | 1);
+        unsigned int b = d[2 * i + 1] + (((k ^ 0x85ebca6bU) >> 1) | 1);
+        sum += static_cast<unsigned long long>(a) * b;
+    }
+    if (n % 2 != 0) {
+        unsigned int k = static_cast<unsigned int>(pairs) * 0x9e3779b9U;
+        unsigned int a = d[n - 1] + ((k >> 1) | 1);
+        sum += static_cast<unsigned long long>(a) * (((k ^ 0x85ebca6bU) >> 1) | 1);
+    }
+    return sum;
+}
+
+// MurmurHash3 の fmix64
+unsigned long long mix(unsigned long long h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// 0 はキャッシュが空の印なので避ける
+std::size_t magnitude_hash(const BigInt::DigitType* d, std::size_t n) {
+    std::size_t h = static_cast<std::size_t>(mix(hash_limbs(d, n) ^ (n * 0x9e3779b97f4a7c15ULL)));
+    return h + (h == 0);
+}
+
+}  // namespace
+
+// limb 部分と長さから作った値に、負なら全ビット反転で符号を混ぜる。
+// 0 は limb が空でも [0] でも同じ値になる。
+std::size_t BigInt::hash() const {
+    const DigitVector& digits = _digits;
+    std::size_t n = isZero() ? 0 : digits.size();
+    const DigitType* d = n > 0 ? &digits[0] : 0;
+#ifdef BIGINT_HASH_CACHE
+    std::size_t h = n > 0 ? digits.cachedHash() : 0;
+    if (h == 0) {
+        h = magnitude_hash(d, n);
+        if (n > 0) {
+            digits.storeHash(h);
+        }
+    }
+#else
+    std::size_t h = magnitude_hash(d, n);
+#endif
+    return _isNegative ? ~h : h;
+}
@@ -0,0 +1,486 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <srcs/BigInt.hpp>
+
+namespace {
+
+const unsigned long long kBase = 1000000000ULL;
+// 小さい素数表の上限。1 limb の数はこの表だけで決定的に判定できる。
+const unsigned int kSmallPrimeLimit = 1 << 16;
+// 多倍長の数に対する試し割りの上限
+const unsigned int kTrialLimit = 1000;
+// next_prime のふるいで一度に見る奇数の候補数
+const std::size_t kSieveWindow = 4096;
+
+std::vector<unsigned int> sieve_small_primes() {
+    std::vector<unsigned int> primes;
+    std::vector<bool> composite(kSmallPrimeLimit, false);
+    for (unsigned int i = 2; i < kSmallPrimeLimit; ++i) {
+        if (composite[i]) {
+            continue;
+        }
+        primes.push_back(i);
+        for (unsigned int j = i * i; j < kSmallPrimeLimit; j += i) {
+            composite[j] = true;
+        }
+    }
+    return primes;
+}
+
+// 関数内 static の初期化は一度だけ、スレッド間でも排他して行われる
+const std::vector<unsigned int>& small_primes() {
+    static const std::vector<unsigned int> primes = sieve_small_primes();
+    return primes;
+}
+
+// a と m (奇数, 正) の Jacobi 記号
+int jacobi_small(unsigned long long a, unsigned long long m) {
+    int j = 1;
+    a %= m;
+    while (a != 0) {
+        while (a % 2 == 0) {
+            a /= 2;
+            if (m % 8 == 3 || m % 8 == 5) {
+                j = -j;
+            }
+        }
+        std::swap(a, m);
+        if (a % 4 == 3 && m % 4 == 3) {
+            j = -j;
+        }
+        a %= m;
+    }
+    return m == 1 ? j : 0;
+}
+
+// Newton 法による floor(sqrt(n))
+BigInt isqrt(const BigInt& n) {
+    BigInt x = BigInt::pow(BigInt(10), 9 * ((n.size() + 1) / 2));
+    for (;;) {
+        BigInt y = (x + n / x) / BigInt(2);
+        if (y >= x) {
+            return x;
+        }
+        x = y;
+    }
+}
+
+std::string bits_of(const BigInt& x) {
+    return x.toString(2);
+}
+
+}  // namespace
+
+// 奇数の法 N (10 と互いに素) に対する基数 10^9 の Montgomery 乗算。
+// R = BASE^n として x を xR mod N で持ち、積の還元は下位 limb を
+// 消していくだけなので、冪乗の各段で多倍長の除算をしない。
+class BigInt::Montgomery {
+ public:
+    typedef PlainDigitVector Limbs;
+
+    explicit Montgomery(const BigInt& modulus)
+        : _modulus(modulus),
+          _m(modulus._digits.begin(), modulus._digits.end()) {
+        while (_m.size() > 1 && _m.back() == 0) {
+            _m.pop_back();
+        }
+        _n = _m.size();
+        _q.resize(_n);
+        _t.resize(_n + 1);
+        // N * x = 1 (mod 10^k) を Newton 法で 10 -> 10^2 -> 10^4 -> 10^8 -> 10^16 と伸ばす
+        static const unsigned long long kInverseMod10[10] = {0, 1, 0, 7, 0, 0, 0, 3, 0, 9};
+        unsigned long long m0 = _m[0];
+        unsigned long long x = kInverseMod10[m0 % 10];
+        for (int i = 0; i < 4; ++i) {
+            unsigned long long t = m0 * x % kBase;
+            x = x * ((2 + kBase - t) % kBase) % kBase;
+        }
+        _inv = static_cast<DigitType>((kBase - x) % kBase);
+    }
+
+    // 0 <= x < N を Montgomery 表現に
+    Limbs to(const BigInt& x) const {
+        return limbs(x.shift_block_left(_n) % _modulus);
+    }
+
+    // 符号付きの小さい値 v (|v| < N) を Montgomery 表現に
+    Limbs to(long long v) const {
+        BigInt x(static_cast<int>(v < 0 ? -v : v));
+        if (v < 0) {
+            x = _modulus - x;
+        }
+        return to(x);
+    }
+
+    // out = a * b / R mod N。out は a, b と同じでもよい。
+    void mul(const Limbs& a, const Limbs& b, Limbs& out) const {
+        multiply(&a[0], &b[0], out);
+    }
+
+    // out = a * a / R mod N
+    void sqr(const Limbs& a, Limbs& out) const {
+        multiply(&a[0], 0, out);
+    }
+
+    // a * c mod N (c は小さい整数)。R を掛けずに済むので足し算の連鎖で行う。
+    void mul_small(Limbs& a, long long c) const {
+        Limbs r(_n, 0);
+        for (unsigned long long k = c < 0 ? -c : c; k > 0; k >>= 1) {
+            if (k & 1) {
+                add(r, a);
+            }
+            add(a, a);
+        }
+        if (c < 0) {
+            a.assign(_n, 0);
+            sub(a, r);
+        } else {
+            a.swap(r);
+        }
+    }
+
+    void add(Limbs& a, const Limbs& b) const {
+        unsigned long long carry = 0;
+        for (std::size_t i = 0; i < _n; ++i) {
+            unsigned long long cur = a[i] + b[i] + carry;
+            carry = cur >= kBase;
+            a[i] = static_cast<DigitType>(cur - carry * kBase);
+        }
+        if (carry || compare_abs(&a[0], _n, &_m[0], _n) >= 0) {
+            subtract_modulus(&a[0]);
+        }
+    }
+
+    void sub(Limbs& a, const Limbs& b) const {
+        long long borrow = 0;
+        for (std::size_t i = 0; i < _n; ++i) {
+            long long cur = static_cast<long long>(a[i]) - b[i] - borrow;
+            borrow = cur < 0;
+            a[i] = static_cast<DigitType>(cur + borrow * static_cast<long long>(kBase));
+        }
+        if (borrow) {
+            unsigned long long carry = 0;
+            for (std::size_t i = 0; i < _n; ++i) {
+                unsigned long long cur = a[i] + _m[i] + carry;
+                carry = cur >= kBase;
+                a[i] = static_cast<DigitType>(cur - carry * kBase);
+            }
+        }
+    }
+
+    // a / 2 mod N。R と 2 は可換なので Montgomery 表現のまま半分にできる。
+    void half(Limbs& a) const {
+        DigitType top = 0;
+        if (a[0] % 2 != 0) {
+            unsigned long long carry = 0;
+            for (std::size_t i = 0; i < _n; ++i) {
+                unsigned long long cur = a[i] + _m[i] + carry;
+                carry = cur >= kBase;
+                a[i] = static_cast<DigitType>(cur - carry * kBase);
+            }
+            top = static_cast<DigitType>(carry);
+        }
+        for (std::size_t i = _n; i > 0; --i) {
+            unsigned long long cur = top * kBase + a[i - 1];
+            a[i - 1] = static_cast<DigitType>(cur / 2);
+            top = static_cast<DigitType>(cur % 2);
+        }
+    }
+
+    // 2^e (e は上位からの 2 進表記)。2 を掛ける段は倍加で済む。
+    Limbs pow2(const std::string& e) const {
+        Limbs r = to(BigInt(2));
+        for (std::size_t i = 1; i < e.size(); ++i) {
+            sqr(r, r);
+            if (e[i] == '1') {
+                add(r, r);
+            }
+        }
+        return r;
+    }
+
+ private:
+    const BigInt& _modulus;
+    std::size_t _n;
+    Limbs _m;
+    DigitType _inv;
+    mutable Limbs _q;
+    mutable Limbs _t;
+
+    Limbs limbs(const BigInt& x) const {
+        Limbs res(_n, 0);
+        for (std::size_t i = 0; i < x._digits.size() && i < _n; ++i) {
+            res[i] = x._digits[i];
+        }
+        return res;
+    }
+
+    // 列ごとに a*b と q*N の積を 128 bit に溜めて (product scanning)、
+    // 列の終わりでだけ BASE で割る。下位 n 列は q を選んで 0 にして捨てる。
+    // b が 0 なら a の 2 乗で、対称な積を 1 回ずつだけ計算する。
+    void multiply(const DigitType* a, const DigitType* b, Limbs& out) const {
+        DigitType* q = &_q[0];
+        DigitType* t = &_t[0];
+        unsigned __int128 acc = 0;
+        for (std::size_t k = 0; k < _n; ++k) {
+            acc += column(a, b, 0, k, k);
+            for (std::size_t i = 0; i < k; ++i) {
+                acc += static_cast<unsigned long long>(q[i]) * _m[k - i];
+            }
+            unsigned long long low = static_cast<unsigned long long>(acc % kBase);
+            q[k] = static_cast<DigitType>(low * _inv % kBase);
+            acc += static_cast<unsigned long long>(q[k]) * _m[0];
+            acc /= kBase;
+        }
+        for (std::size_t k = _n; k < 2 * _n - 1; ++k) {
+            acc += column(a, b, k - _n + 1, _n - 1, k);
+            for (std::size_t i = k - _n + 1; i < _n; ++i) {
+                acc += static_cast<unsigned long long>(q[i]) * _m[k - i];
+            }
+            t[k - _n] = static_cast<DigitType>(acc % kBase);
+            acc /= kBase;
+        }
+        t[_n - 1] = static_cast<DigitType>(acc % kBase);
+        t[_n] = static_cast<DigitType>(acc / kBase);
+        // 結果は 2N 未満なので高々 1 回引けば済む
+        if (t[_n] != 0 || compare_abs(t, _n, &_m[0], _n) >= 0) {
+            subtract_modulus(t);
+        }
+        out.assign(_t.begin(), _t.begin() + _n);
+    }
+
+    // sum a[i] * b[k - i] (lo <= i <= hi)
+    static unsigned __int128 column(const DigitType* a, const DigitType* b,
+                                    std::size_t lo, std::size_t hi, std::size_t k) {
+        unsigned __int128 sum = 0;
+        if (b) {
+            for (std::size_t i = lo; i <= hi; ++i) {
+                sum += static_cast<unsigned long long>(a[i]) * b[k - i];
+            }
+            return sum;
+        }
+        for (std::size_t i = lo; 2 * i < k; ++i) {
+            sum += static_cast<unsigned long long>(a[i]) * a[k - i];
+        }
+        sum += sum;
+        if (k % 2 == 0) {
+            sum += static_cast<unsigned long long>(a[k / 2]) * a[k / 2];
+        }
+        return sum;
+    }
+
+    void subtract_modulus(DigitType* t) const {
+        long long borrow = 0;
+        for (std::size_t i = 0; i < _n; ++i) {
+            long long cur = static_cast<long long>(t[i]) - _m[i] - borrow;
+            borrow = cur < 0;
+            t[i] = static_cast<DigitType>(cur + borrow * static_cast<long long>(kBase));
+        }
+    }
+};
+
+BigInt::DigitType BigInt::mod_small(DigitType m) const {
+    unsigned long long r = 0;
+    for (std::size_t i = _digits.size(); i > 0; --i) {
+        r = (r * kBase + _digits[i - 1]) % m;
+    }
+    return static_cast<DigitType>(r);
+}
+
+// 素数表の先頭 count 個それぞれで割った余り。2^32 に収まるだけ素数を
+// まとめた積で一度割ってから個々の素数で割るので、limb の走査は数分の一で済む。
+void BigInt::small_residues(std::size_t count, PlainDigitVector& out) const {
+    const std::vector<unsigned int>& primes = small_primes();
+    out.resize(count);
+    std::size_t i = 0;
+    while (i < count) {
+        unsigned long long product = primes[i];
+        std::size_t end = i + 1;
+        while (end < count && product * primes[end] <= 0xffffffffULL) {
+            product *= primes[end];
+            ++end;
+        }
+        unsigned long long r = mod_small(static_cast<DigitType>(product));
+        for (; i < end; ++i) {
+            out[i] = static_cast<DigitType>(r % primes[i]);
+        }
+    }
+}
+
+// 試し割りのあと BPSW (底 2 の Miller-Rabin と強 Lucas 判定) を行う。
+// 1 limb に収まる数は素数表で決定的に判定する。2 未満と負の数は false。
+bool BigInt::isProbablePrime() const {
+    if (_isNegative || isZero()) {
+        return false;
+    }
+    const std::vector<unsigned int>& primes = small_primes();
+    if (_digits.size() == 1) {
+        unsigned int n = _digits[0];
+        if (n < 2) {
+            return false;
+        }
+        for (std::size_t i = 0; i < primes.size(); ++i) {
+            unsigned long long p = primes[i];
+            if (p * p > n) {
+                break;
+            }
+            if (n % p == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t trial = std::lower_bound(primes.begin(), primes.end(), kTrialLimit)
+        - primes.begin();
+    PlainDigitVector residues;
+    small_residues(trial, residues);
+    for (std::size_t i = 0; i < trial; ++i) {
+        if (residues[i] == 0) {
+            return false;
+        }
+    }
+
+    Montgomery mont(*this);
+    Montgomery::Limbs one = mont.to(BigInt(1));
+    Montgomery::Limbs minus_one = mont.to(-1LL);
+
+    // n - 1 = d * 2^s として 2^d, 2^(2d), ... に -1 が現れるか
+    std::string e = bits_of(*this - BigInt(1));
+    std::size_t s = e.size() - 1 - e.find_last_of('1');
+    Montgomery::Limbs x = mont.pow2(e.substr(0, e.size() - s));
+    if (x != one && x != minus_one) {
+        std::size_t r = 1;
+        for (; r < s; ++r) {
+            mont.sqr(x, x);
+            if (x == minus_one) {
+                break;
+            }
+            if (x == one) {
+                return false;
+            }
+        }
+        if (r == s) {
+            return false;
+        }
+    }
+
+    // Selfridge の方法 A: D = 5, -7, 9, -11, ... で (D/n) = -1 となる最初のもの。
+    // 平方数だと見つからないので、何回か外れたら平方数かどうか確かめる。
+    long long d = 5;
+    for (int tries = 0;; ++tries) {
+        unsigned long long a = d < 0 ? -d : d;
+        int j = jacobi_small(mod_small(static_cast<DigitType>(a)), a);
+        if (a % 4 == 3 && _digits[0] % 4 == 3) {
+            j = -j;
+        }
+        if (d < 0 && _digits[0] % 4 == 3) {
+            j = -j;
+        }
+        if (j == -1) {
+            break;
+        }
+        if (j == 0) {
+            return false;
+        }
+        if (tries == 5) {
+            BigInt root = isqrt(*this);
+            if (root * root == *this) {
+                return false;
+            }
+        }
+        d = d < 0 ? -d + 2 : -(d + 2);
+    }
+
+    // 強 Lucas 判定 (P = 1, Q = (1 - D) / 4)。n + 1 = d' * 2^s'
+    long long q = (1 - d) / 4;
+    e = bits_of(*this + BigInt(1));
+    s = e.size() - 1 - e.find_last_of('1');
+    e.erase(e.size() - s);
+
+    Montgomery::Limbs u = one;
+    Montgomery::Limbs v = one;
+    Montgomery::Limbs qk = mont.to(q);
+    Montgomery::Limbs du;
+    for (std::size_t i = 1; i < e.size(); ++i) {
+        // U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k
+        mont.mul(u, v, u);
+        mont.sqr(v, v);
+        mont.sub(v, qk);
+        mont.sub(v, qk);
+        mont.sqr(qk, qk);
+        if (e[i] == '1') {
+            // U_k+1 = (U_k + V_k) / 2, V_k+1 = (D U_k + V_k) / 2
+            du = u;
+            mont.mul_small(du, d);
+            mont.add(u, v);
+            mont.half(u);
+            mont.add(v, du);
+            mont.half(v);
+            mont.mul_small(qk, q);
+        }
+    }
+    Montgomery::Limbs zero(one.size(), 0);
+    if (u == zero || v == zero) {
+        return true;
+    }
+    for (std::size_t r = 1; r < s; ++r) {
+        mont.sqr(v, v);
+        mont.sub(v, qk);
+        mont.sub(v, qk);
+        if (v == zero) {
+            return true;
+        }
+        mont.sqr(qk, qk);
+    }
+    return false;
+}
+
+// n より大きい最小の (確率的) 素数。
+// 多倍長の候補は奇数の並びを素数表でふるい、残ったものだけを判定する。
+BigInt BigInt::nextPrime(const BigInt& n) {
+    if (n < BigInt(2)) {
+        return BigInt(2);
+    }
+    BigInt c = n + BigInt(1);
+    if (c._digits[0] % 2 == 0) {
+        ++c;
+    }
+    while (c._digits.size() == 1) {
+        if (c.isProbablePrime()) {
+            return c;
+        }
+        c += BigInt(2);
+    }
+
+    const std::vector<unsigned int>& primes = small_primes();
+    PlainDigitVector residues;
+    c.small_residues(primes.size(), residues);
+    std::vector<bool> composite(kSieveWindow);
+    for (;;) {
+        // c + 2k が p で割り切れる k を消す (2 は候補が奇数なので除く)
+        std::fill(composite.begin(), composite.end(), false);
+        for (std::size_t i = 1; i < primes.size(); ++i) {
+            unsigned long long p = primes[i];
+            unsigned long long k = (p - residues[i]) % p * ((p + 1) / 2) % p;
+            for (; k < kSieveWindow; k += p) {
+                composite[k] = true;
+            }
+        }
+        for (std::size_t k = 0; k < kSieveWindow; ++k) {
+            if (composite[k]) {
+                continue;
+            }
+            BigInt candidate = c + BigInt(static_cast<int>(2 * k));
+            if (candidate.isProbablePrime()) {
+                return candidate;
+            }
+        }
+        c += BigInt(static_cast<int>(2 * kSieveWindow));
+        for (std::size_t i = 1; i < primes.size(); ++i) {
+            residues[i] = static_cast<DigitType>((residues[i] + 2 * kSieveWindow) % primes[i]);
+        }
+    }
+}
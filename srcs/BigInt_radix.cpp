@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include <srcs/BigInt.hpp>
+
+namespace {
+
+const unsigned long long kBase = 1000000000ULL;
+const unsigned long long kWordRadix = 1ULL << 32;
+const std::size_t kWordBits = 32;
+const char kDigitChars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+// キャッシュする radix^(2^k) の limb 数の上限。基数あたり高々 2 倍の 32 KB 程度
+const std::size_t kCachedPowerLimbs = 4096;
+
+void check_base(int base) {
+    if (base < 2 || base > 36) {
+        throw std::invalid_argument("BigInt radix error: base must be between 2 and 36");
+    }
+}
+
+// 2 の冪なら 1 桁あたりのビット数、そうでなければ 0
+std::size_t bits_per_digit(int base) {
+    std::size_t bits = 0;
+    while ((1 << bits) < base) {
+        ++bits;
+    }
+    return (1 << bits) == base ? bits : 0;
+}
+
+// base^m <= 2^32 となる最大の m
+std::size_t digits_per_chunk(int base) {
+    std::size_t m = 0;
+    unsigned long long p = 1;
+    while (p * base <= kWordRadix) {
+        p *= base;
+        ++m;
+    }
+    return m;
+}
+
+int digit_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    return 36;
+}
+
+// radix_powers のキャッシュを守る
+pthread_mutex_t radix_powers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+class ScopedLock {
+ public:
+    explicit ScopedLock(pthread_mutex_t& mutex) : _mutex(mutex) {
+        pthread_mutex_lock(&_mutex);
+    }
+    ~ScopedLock() {
+        pthread_mutex_unlock(&_mutex);
+    }
+
+ private:
+    pthread_mutex_t& _mutex;
+
+    ScopedLock(const ScopedLock&);
+    ScopedLock& operator=(const ScopedLock&);
+};
+
+std::size_t ceil_log2(std::size_t n) {
+    std::size_t level = 0;
+    while ((static_cast<std::size_t>(1) << level) < n) {
+        ++level;
+    }
+    return level;
+}
+
+}  // namespace
+
+BigInt::BigInt(const std::string& str, int base)
+    : _digits(), _isNegative(false) {
+    check_base(base);
+    if (base == 10) {
+        BigInt(str).swap(*this);
+        return;
+    }
+    BIGINT_STATS_SCOPE(FROM_RADIX, str.size() / 9);
+    if (str.empty()) {
+        throw std::invalid_argument("Invalid string for BigInt: empty string");
+    }
+    std::size_t startIndex = 0;
+    if (str[0] == '-' || str[0] == '+') {
+        startIndex = 1;
+    }
+    if (startIndex == str.size()) {
+        throw std::invalid_argument("Invalid string for BigInt: no digits");
+    }
+    for (std::size_t i = startIndex; i < str.size(); ++i) {
+        if (digit_value(str[i]) >= base) {
+            throw std::invalid_argument("Invalid string for BigInt: digit out of range for base");
+        }
+    }
+    while (startIndex < str.size() - 1 && str[startIndex] == '0') {
+        startIndex++;
+    }
+    std::size_t ndigits = str.size() - startIndex;
+
+    std::vector<DigitType> chunks;
+    unsigned long long radix;
+    std::size_t bits = bits_per_digit(base);
+    if (bits > 0) {
+        // 2 の冪: 各桁のビットを 32bit 語へそのまま並べる (線形時間)
+        radix = kWordRadix;
+        chunks.assign((ndigits * bits + kWordBits - 1) / kWordBits, 0);
+        std::size_t pos = 0;
+        for (std::size_t i = str.size(); i > startIndex; --i, pos += bits) {
+            unsigned long long v = digit_value(str[i - 1]);
+            std::size_t w = pos / kWordBits;
+            std::size_t off = pos % kWordBits;
+            chunks[w] |= static_cast<DigitType>(v << off);
+            if (off + bits > kWordBits) {
+                chunks[w + 1] |= static_cast<DigitType>(v >> (kWordBits - off));
+            }
+        }
+    } else {
+        std::size_t m = digits_per_chunk(base);
+        radix = 1;
+        for (std::size_t i = 0; i < m; ++i) {
+            radix *= base;
+        }
+        for (std::size_t end = str.size(); end > startIndex; ) {
+            std::size_t begin = end - startIndex > m ? end - m : startIndex;
+            unsigned long long v = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+                v = v * base + digit_value(str[i]);
+            }
+            chunks.push_back(static_cast<DigitType>(v));
+            end = begin;
+        }
+    }
+    std::size_t level = ceil_log2(chunks.size());
+    chunks.resize(static_cast<std::size_t>(1) << level, 0);
+    std::vector<BigInt> powers;
+    radix_powers(radix, level, powers);
+    BigInt result = from_radix_chunks(&chunks[0], powers, level);
+    result._isNegative = (str[0] == '-');
+    result.normalize();
+    swap(result);
+}
+
+std::string BigInt::toString(int base) const {
+    check_base(base);
+    if (base == 10) {
+        return toString();
+    }
+    if (isZero()) {
+        return "0";
+    }
+    BIGINT_STATS_SCOPE(TO_RADIX, _digits.size());
+    std::size_t bits = bits_per_digit(base);
+    std::size_t m = bits > 0 ? 0 : digits_per_chunk(base);
+    unsigned long long radix = kWordRadix;
+    if (bits == 0) {
+        radix = 1;
+        for (std::size_t i = 0; i < m; ++i) {
+            radix *= base;
+        }
+    }
+
+    BigInt x = abs();
+    std::size_t level = 0;
+    std::vector<BigInt> powers;
+    radix_powers(radix, 0, powers);
+    while (x.compare_abs(powers[level]) >= 0) {
+        ++level;
+        radix_powers(radix, level, powers);
+    }
+    std::vector<DigitType> chunks(static_cast<std::size_t>(1) << level, 0);
+    to_radix_chunks(x, powers, level, &chunks[0]);
+    while (chunks.size() > 1 && chunks.back() == 0) {
+        chunks.pop_back();
+    }
+
+    std::string out;
+    if (bits > 0) {
+        // 2 の冪: 32bit 語の並びから各桁のビットを切り出す (線形時間)
+        std::size_t totalBits = chunks.size() * kWordBits;
+        for (DigitType top = chunks.back(); !(top & 0x80000000u); top <<= 1) {
+            --totalBits;
+        }
+        std::size_t ndigits = (totalBits + bits - 1) / bits;
+        out.resize(ndigits);
+        DigitType mask = (1u << bits) - 1;
+        for (std::size_t i = 0, pos = 0; i < ndigits; ++i, pos += bits) {
+            std::size_t w = pos / kWordBits;
+            std::size_t off = pos % kWordBits;
+            unsigned long long v = chunks[w] >> off;
+            if (off + bits > kWordBits && w + 1 < chunks.size()) {
+                v |= static_cast<unsigned long long>(chunks[w + 1]) << (kWordBits - off);
+            }
+            out[ndigits - 1 - i] = kDigitChars[v & mask];
+        }
+    } else {
+        out.resize(chunks.size() * m);
+        std::size_t pos = out.size();
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            DigitType v = chunks[i];
+            for (std::size_t j = 0; j < m; ++j) {
+                out[--pos] = kDigitChars[v % base];
+                v /= base;
+            }
+        }
+        std::size_t first = out.find_first_not_of('0');
+        out.erase(0, first);
+    }
+    if (_isNegative) {
+        out.insert(out.begin(), '-');
+    }
+    return out;
+}
+
+// radix^(2^k) (k = 0..level) の表のうち、powers に無い段を足す。
+// kCachedPowerLimbs 以下の段は基数ごとにプロセス全体でキャッシュするが、
+// 触るのはロックの中だけで、呼び出し側には limb を複製して渡す
+// (BIGINT_COW でも共有しない)。それより大きい段は呼び出しごとに二乗して作る。
+void BigInt::radix_powers(unsigned long long radix, std::size_t level,
+                          std::vector<BigInt>& powers) {
+    static std::map<unsigned long long, std::vector<BigInt> > cache;
+    {
+        ScopedLock lock(radix_powers_mutex);
+        std::vector<BigInt>& cached = cache[radix];
+        if (cached.empty()) {
+            BigInt p;
+            for (unsigned long long v = radix; v > 0; v /= kBase) {
+                p._digits.push_back(static_cast<DigitType>(v % kBase));
+            }
+            cached.push_back(p);
+        }
+        while (cached.size() <= level
+                && cached.back()._digits.size() * 2 <= kCachedPowerLimbs) {
+            const BigInt& last = cached.back();
+            cached.push_back(last.karatsuba_multiply(last, last));
+        }
+        for (std::size_t k = powers.size(); k <= level && k < cached.size(); ++k) {
+            const DigitVector& digits = cached[k]._digits;
+            powers.push_back(BigInt());
+            powers.back()._digits.assign(digits.begin(), digits.end());
+        }
+    }
+    while (powers.size() <= level) {
+        const BigInt& last = powers.back();
+        powers.push_back(last.karatsuba_multiply(last, last));
+    }
+}
+
+// x (< radix^(2^level)) を radix 進で 2^level 個のチャンクに展開する (下位から)
+void BigInt::to_radix_chunks(const BigInt& x,
+                             const std::vector<BigInt>& powers,
+                             std::size_t level,
+                             DigitType* out) {
+    std::size_t count = static_cast<std::size_t>(1) << level;
+    if (level == 0 || x._digits.size() <= RADIX_THRESHOLD) {
+        unsigned long long radix = 0;
+        for (std::size_t i = powers[0]._digits.size(); i > 0; --i) {
+            radix = radix * kBase + powers[0]._digits[i - 1];
+        }
+        DigitVector rest_digits = x._digits;
+        std::size_t len = x.isZero() ? 0 : rest_digits.size();
+        DigitType* rest = mutable_data(rest_digits);
+        for (std::size_t c = 0; c < count; ++c) {
+            unsigned long long rem = 0;
+            for (std::size_t i = len; i > 0; --i) {
+                unsigned long long cur = rem * kBase + rest[i - 1];
+                rest[i - 1] = static_cast<DigitType>(cur / radix);
+                rem = cur % radix;
+            }
+            while (len > 0 && rest[len - 1] == 0) {
+                --len;
+            }
+            out[c] = static_cast<DigitType>(rem);
+        }
+        return;
+    }
+    BigInt q, r;
+    x.division_and_remainder(x, powers[level - 1], q, r);
+    to_radix_chunks(r, powers, level - 1, out);
+    to_radix_chunks(q, powers, level - 1, out + count / 2);
+}
+
+// 2^level 個の radix 進チャンク (下位から) を BigInt に戻す。
+// 結果は radix^(2^level) 未満なので、その limb 数を to_radix_chunks と同じ
+// 単位として RADIX_THRESHOLD と比べる。
+BigInt BigInt::from_radix_chunks(const DigitType* chunks,
+                                 const std::vector<BigInt>& powers,
+                                 std::size_t level) {
+    std::size_t count = static_cast<std::size_t>(1) << level;
+    if (level == 0 || powers[level]._digits.size() <= RADIX_THRESHOLD) {
+        unsigned long long radix = 0;
+        for (std::size_t i = powers[0]._digits.size(); i > 0; --i) {
+            radix = radix * kBase + powers[0]._digits[i - 1];
+        }
+        BigInt res;
+        for (std::size_t c = count; c > 0; --c) {
+            unsigned long long carry = chunks[c - 1];
+            DigitType* d = mutable_data(res._digits);
+            for (std::size_t i = 0; i < res._digits.size(); ++i) {
+                unsigned long long cur = d[i] * radix + carry;
+                d[i] = static_cast<DigitType>(cur % kBase);
+                carry = cur / kBase;
+            }
+            while (carry > 0) {
+                res._digits.push_back(static_cast<DigitType>(carry % kBase));
+                carry /= kBase;
+            }
+        }
+        if (res._digits.empty()) {
+            res._digits.push_back(0);
+        }
+        return res;
+    }
+    BigInt high = from_radix_chunks(chunks + count / 2, powers, level - 1);
+    BigInt low = from_radix_chunks(chunks, powers, level - 1);
+    BigInt res = high.isZero() ? high : high.karatsuba_multiply(high, powers[level - 1]);
+    add_abs(res, low);
+    return res;
+}
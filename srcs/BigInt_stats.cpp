@@ -0,0 +1,132 @@
+#include <ctime>
+#include <sstream>
+#include <string>
+
+#include <srcs/BigInt_stats.hpp>
+
+namespace {
+
+BigIntStats::Counter g_counters[BigIntStats::ALGORITHM_COUNT];
+BigIntStats::Allocations g_allocations;
+
+const char* const kNames[BigIntStats::ALGORITHM_COUNT] = {
+    "schoolbook_multiply",
+    "karatsuba_multiply",
+    "division",
+    "schoolbook_division",
+    "burnikel_ziegler",
+    "divide_2n_by_n",
+    "bz_schoolbook_fallback",
+    "to_string",
+    "parse",
+    "to_radix",
+    "from_radix"
+};
+
+unsigned long long now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+std::size_t bucket_of(std::size_t limbs) {
+    std::size_t b = 0;
+    while (limbs > 1 && b + 1 < BigIntStats::HISTOGRAM_BUCKETS) {
+        limbs >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+}  // namespace
+
+BigIntStats::Scope::Scope(Algorithm algorithm, std::size_t limbs)
+    : _algorithm(algorithm), _limbs(limbs), _start(now_ns()) {}
+
+BigIntStats::Scope::~Scope() {
+    record(_algorithm, _limbs, now_ns() - _start);
+}
+
+void BigIntStats::Scope::setLimbs(std::size_t limbs) {
+    _limbs = limbs;
+}
+
+bool BigIntStats::enabled() {
+#ifdef BIGINT_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* BigIntStats::name(Algorithm algorithm) {
+    return kNames[algorithm];
+}
+
+const BigIntStats::Counter& BigIntStats::counter(Algorithm algorithm) {
+    return g_counters[algorithm];
+}
+
+const BigIntStats::Allocations& BigIntStats::allocations() {
+    return g_allocations;
+}
+
+double BigIntStats::fallbackRatio() {
+    unsigned long long splits = g_counters[DIVIDE_2N_BY_N].calls;
+    if (splits == 0) {
+        return 0;
+    }
+    return static_cast<double>(g_counters[BZ_SCHOOLBOOK_FALLBACK].calls) / splits;
+}
+
+void BigIntStats::reset() {
+    for (std::size_t i = 0; i < ALGORITHM_COUNT; ++i) {
+        g_counters[i] = Counter();
+    }
+    unsigned long long live = g_allocations.liveBytes;
+    g_allocations = Allocations();
+    g_allocations.liveBytes = live;
+    g_allocations.peakBytes = live;
+}
+
+std::string BigIntStats::toJson() {
+    std::ostringstream oss;
+    oss << "{\"enabled\": " << (enabled() ? "true" : "false")
+        << ", \"algorithms\": {";
+    for (std::size_t i = 0; i < ALGORITHM_COUNT; ++i) {
+        const Counter& c = g_counters[i];
+        oss << (i ? ", " : "") << "\"" << kNames[i] << "\": {\"calls\": " << c.calls
+            << ", \"nanoseconds\": " << c.nanoseconds << ", \"histogram\": [";
+        for (std::size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            oss << (b ? ", " : "") << c.histogram[b];
+        }
+        oss << "]}";
+    }
+    oss << "}, \"bz_fallback_ratio\": " << fallbackRatio()
+        << ", \"allocations\": {\"count\": " << g_allocations.count
+        << ", \"bytes\": " << g_allocations.bytes
+        << ", \"live_bytes\": " << g_allocations.liveBytes
+        << ", \"peak_bytes\": " << g_allocations.peakBytes << "}}";
+    return oss.str();
+}
+
+void BigIntStats::record(Algorithm algorithm, std::size_t limbs,
+                         unsigned long long nanoseconds) {
+    Counter& c = g_counters[algorithm];
+    ++c.calls;
+    c.nanoseconds += nanoseconds;
+    ++c.histogram[bucket_of(limbs)];
+}
+
+void BigIntStats::recordAllocation(std::size_t bytes) {
+    ++g_allocations.count;
+    g_allocations.bytes += bytes;
+    g_allocations.liveBytes += bytes;
+    if (g_allocations.liveBytes > g_allocations.peakBytes) {
+        g_allocations.peakBytes = g_allocations.liveBytes;
+    }
+}
+
+void BigIntStats::recordDeallocation(std::size_t bytes) {
+    g_allocations.liveBytes -= bytes;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+// ホットパスの計測。BIGINT_STATS を定義してビルドしたときだけ
+// 各アルゴリズムにフックが入り、limb 配列の確保量も数える。
+// 定義しなければフックは空のマクロになり、実行時コストは無い。
+// 集計はスレッドセーフではない。
+class BigIntStats {
+ public:
+    enum Algorithm {
+        SCHOOLBOOK_MULTIPLY,
+        KARATSUBA_MULTIPLY,
+        DIVISION,
+        SCHOOLBOOK_DIVISION,
+        BURNIKEL_ZIEGLER,
+        DIVIDE_2N_BY_N,
+        BZ_SCHOOLBOOK_FALLBACK,
+        TO_STRING,
+        PARSE,
+        TO_RADIX,
+        FROM_RADIX,
+        ALGORITHM_COUNT
+    };
+    // limb 数の log2 ごとの度数 (最後の bucket はそれ以上すべて)
+    static const std::size_t HISTOGRAM_BUCKETS = 24;
+
+    struct Counter {
+        unsigned long long calls;
+        // 再帰の内側で呼ばれた分も含む経過時間
+        unsigned long long nanoseconds;
+        unsigned long long histogram[HISTOGRAM_BUCKETS];
+    };
+
+    struct Allocations {
+        unsigned long long count;
+        unsigned long long bytes;
+        unsigned long long liveBytes;
+        unsigned long long peakBytes;
+    };
+
+    // 計測中のスコープ。生成から破棄までの時間を記録する。
+    class Scope {
+     public:
+        Scope(Algorithm algorithm, std::size_t limbs);
+        ~Scope();
+        // 読み込みのように、終わるまで limb 数が分からないときに後から入れる
+        void setLimbs(std::size_t limbs);
+
+     private:
+        Algorithm _algorithm;
+        std::size_t _limbs;
+        unsigned long long _start;
+
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+    };
+
+    // limb 配列用のアロケータ。確保・解放のたびに Allocations を更新する。
+    template <typename T>
+    class Allocator {
+     public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind {
+            typedef Allocator<U> other;
+        };
+
+        Allocator() {}
+        template <typename U>
+        Allocator(const Allocator<U>&) {}
+
+        pointer address(reference x) const { return &x; }
+        const_pointer address(const_reference x) const { return &x; }
+        size_type max_size() const { return static_cast<size_type>(-1) / sizeof(T); }
+        void construct(pointer p, const T& value) { new (p) T(value); }
+        void destroy(pointer p) { p->~T(); }
+
+        pointer allocate(size_type n, const void* = 0) {
+            recordAllocation(n * sizeof(T));
+            return static_cast<pointer>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(pointer p, size_type n) {
+            recordDeallocation(n * sizeof(T));
+            ::operator delete(p);
+        }
+    };
+
+    static bool enabled();
+    static const char* name(Algorithm algorithm);
+    static const Counter& counter(Algorithm algorithm);
+    static const Allocations& allocations();
+    // 2n/n 分割のうち、schoolbook に落ちた割合
+    static double fallbackRatio();
+    static void reset();
+    static std::string toJson();
+
+    static void record(Algorithm algorithm, std::size_t limbs,
+                       unsigned long long nanoseconds);
+    static void recordAllocation(std::size_t bytes);
+    static void recordDeallocation(std::size_t bytes);
+};
+
+template <typename T, typename U>
+bool operator==(const BigIntStats::Allocator<T>&, const BigIntStats::Allocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const BigIntStats::Allocator<T>&, const BigIntStats::Allocator<U>&) {
+    return false;
+}
+
+#ifdef BIGINT_STATS
+#define BIGINT_STATS_CONCAT_(a, b) a##b
+#define BIGINT_STATS_CONCAT(a, b) BIGINT_STATS_CONCAT_(a, b)
+#define BIGINT_STATS_SCOPE(algorithm, limbs) \
+    BigIntStats::Scope BIGINT_STATS_CONCAT(bigint_stats_scope_, __LINE__)( \
+        BigIntStats::algorithm, (limbs))
+// 名前付きのスコープ。BIGINT_STATS_SET_LIMBS で limb 数を後から入れる
+#define BIGINT_STATS_NAMED_SCOPE(scope, algorithm, limbs) \
+    BigIntStats::Scope scope(BigIntStats::algorithm, (limbs))
+#define BIGINT_STATS_SET_LIMBS(scope, limbs) (scope).setLimbs(limbs)
+#define BIGINT_STATS_COUNT(algorithm, limbs) \
+    BigIntStats::record(BigIntStats::algorithm, (limbs), 0)
+#else
+#define BIGINT_STATS_SCOPE(algorithm, limbs) ((void)0)
+#define BIGINT_STATS_NAMED_SCOPE(scope, algorithm, limbs) ((void)0)
+#define BIGINT_STATS_SET_LIMBS(scope, limbs) ((void)0)
+#define BIGINT_STATS_COUNT(algorithm, limbs) ((void)0)
+#endif
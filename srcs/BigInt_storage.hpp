@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// limb 配列の要素を書き換えるときの入口。要素ごとの operator[] ではなく、
+// 演算の最初に一度これで先頭のポインタを取り、あとはポインタで書く。
+// std::vector ならそのまま先頭を返し、下のラッパーは mutableData() で
+// 共有の解除 (SharedDigits) やハッシュの破棄 (HashedDigits) を一度だけ行う。
+// 取ったポインタは、サイズを変える操作をするか、値をコピーしたら捨てること。
+template <typename Vector>
+typename Vector::value_type* mutable_data(Vector& v) {
+    return v.mutableData();
+}
+
+template <typename T, typename Allocator>
+T* mutable_data(std::vector<T, Allocator>& v) {
+    return v.empty() ? 0 : &v[0];
+}
+
+// 参照カウント付きの copy-on-write な limb 配列。BIGINT_COW を定義して
+// ビルドしたときだけ BigInt::DigitVector がこれになる。
+// コピー・代入・swap はポインタの付け替えだけで、書き込みの直前
+// (mutable_data() とサイズを変える操作) に共有されていれば複製する。
+// 要素の参照は const でしか渡さないので、書き込みは必ず mutable_data() を通る。
+// BIGINT_COW_ATOMIC を定義すると参照カウントを atomic に更新するので、
+// 同じ limb 配列を共有する BigInt を別スレッドに渡してよい。
+template <typename Vector>
+class SharedDigits {
+ public:
+    typedef typename Vector::value_type value_type;
+    typedef typename Vector::size_type size_type;
+    typedef typename Vector::reference reference;
+    typedef typename Vector::const_reference const_reference;
+    typedef typename Vector::iterator iterator;
+    typedef typename Vector::const_iterator const_iterator;
+
+    SharedDigits() : _block(0) {}
+
+    SharedDigits(const SharedDigits& other) : _block(other._block) {
+        retain(_block);
+    }
+
+    SharedDigits& operator=(const SharedDigits& rhs) {
+        retain(rhs._block);
+        release(_block);
+        _block = rhs._block;
+        return *this;
+    }
+
+    ~SharedDigits() {
+        release(_block);
+    }
+
+    void swap(SharedDigits& other) {
+        Block* tmp = _block;
+        _block = other._block;
+        other._block = tmp;
+    }
+
+    // 同じ limb 配列を指しているか
+    bool shares(const SharedDigits& other) const {
+        return _block != 0 && _block == other._block;
+    }
+
+    size_type size() const { return _block ? _block->digits.size() : 0; }
+    bool empty() const { return size() == 0; }
+    const_reference operator[](size_type i) const { return _block->digits[i]; }
+    const_reference back() const { return _block->digits.back(); }
+    const_iterator begin() const { return view().begin(); }
+    const_iterator end() const { return view().end(); }
+
+    // 共有を一度だけ解除して先頭を返す (空なら 0)
+    value_type* mutableData() { return mutable_data(unique()); }
+
+    void push_back(const value_type& v) { unique().push_back(v); }
+    void pop_back() { unique().pop_back(); }
+    void resize(size_type n, value_type v = value_type()) { unique().resize(n, v); }
+    void assign(size_type n, const value_type& v) { unique().assign(n, v); }
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) { unique().assign(first, last); }
+
+    void clear() {
+        release(_block);
+        _block = 0;
+    }
+
+    // 下の層が HashedDigits のときだけ使う。共有中のコピー同士でキャッシュを使い回す
+    std::size_t cachedHash() const { return view().cachedHash(); }
+    void storeHash(std::size_t h) const {
+        if (_block != 0) {
+            _block->digits.storeHash(h);
+        }
+    }
+
+ private:
+    struct Block {
+        Block() : refs(1), digits() {}
+        explicit Block(const Vector& v) : refs(1), digits(v) {}
+
+        long refs;
+        Vector digits;
+    };
+
+    Block* _block;
+
+    static const Vector& empty_vector() {
+        static const Vector v;
+        return v;
+    }
+
+    const Vector& view() const {
+        return _block ? _block->digits : empty_vector();
+    }
+
+    // 書き込み前に呼ぶ。共有されていれば自分用に複製する。
+    Vector& unique() {
+        if (_block == 0) {
+            _block = new Block();
+        } else if (load(_block) != 1) {
+            Block* copy = new Block(_block->digits);
+            release(_block);
+            _block = copy;
+        }
+        return _block->digits;
+    }
+
+    static void retain(Block* b) {
+        if (b == 0) {
+            return;
+        }
+#ifdef BIGINT_COW_ATOMIC
+        __atomic_add_fetch(&b->refs, 1, __ATOMIC_RELAXED);
+#else
+        ++b->refs;
+#endif
+    }
+
+    static void release(Block* b) {
+        if (b == 0) {
+            return;
+        }
+#ifdef BIGINT_COW_ATOMIC
+        if (__atomic_sub_fetch(&b->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+            delete b;
+        }
+#else
+        if (--b->refs == 0) {
+            delete b;
+        }
+#endif
+    }
+
+    static long load(const Block* b) {
+#ifdef BIGINT_COW_ATOMIC
+        return __atomic_load_n(&b->refs, __ATOMIC_ACQUIRE);
+#else
+        return b->refs;
+#endif
+    }
+};
+
+// ハッシュ値のキャッシュ付きの limb 配列。BIGINT_HASH_CACHE を定義して
+// ビルドしたときだけ BigInt の limb 配列がこれになる (BIGINT_COW と重ねる
+// ときは SharedDigits の内側で、共有している間はキャッシュも共有する)。
+// 書き込みは mutable_data() かサイズを変える操作を通るので、そこで一度だけ
+// キャッシュを捨てる。要素の参照は const でしか渡さない。
+template <typename Vector>
+class HashedDigits {
+ public:
+    typedef typename Vector::value_type value_type;
+    typedef typename Vector::size_type size_type;
+    typedef typename Vector::reference reference;
+    typedef typename Vector::const_reference const_reference;
+    typedef typename Vector::iterator iterator;
+    typedef typename Vector::const_iterator const_iterator;
+
+    HashedDigits() : _digits(), _hash(0) {}
+    HashedDigits(const HashedDigits& other)
+        : _digits(other._digits), _hash(other.cachedHash()) {}
+
+    HashedDigits& operator=(const HashedDigits& rhs) {
+        _digits = rhs._digits;
+        _hash = rhs.cachedHash();
+        return *this;
+    }
+
+    void swap(HashedDigits& other) {
+        _digits.swap(other._digits);
+        std::size_t tmp = _hash;
+        _hash = other._hash;
+        other._hash = tmp;
+    }
+
+    size_type size() const { return _digits.size(); }
+    bool empty() const { return _digits.empty(); }
+    const_reference operator[](size_type i) const { return _digits[i]; }
+    const_reference back() const { return _digits.back(); }
+    const_iterator begin() const { return _digits.begin(); }
+    const_iterator end() const { return _digits.end(); }
+
+    value_type* mutableData() { return mutable_data(touch()); }
+
+    void push_back(const value_type& v) { touch().push_back(v); }
+    void pop_back() { touch().pop_back(); }
+    void resize(size_type n, value_type v = value_type()) { touch().resize(n, v); }
+    void assign(size_type n, const value_type& v) { touch().assign(n, v); }
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) { touch().assign(first, last); }
+    void clear() { touch().clear(); }
+
+    // 0 ならまだ計算していない。const の BigInt を複数スレッドから
+    // hash() してよいように、読み書きは 1 語の relaxed atomic にする。
+    std::size_t cachedHash() const {
+        return __atomic_load_n(&_hash, __ATOMIC_RELAXED);
+    }
+    void storeHash(std::size_t h) const {
+        __atomic_store_n(&_hash, h, __ATOMIC_RELAXED);
+    }
+
+ private:
+    Vector _digits;
+    mutable std::size_t _hash;
+
+    Vector& touch() {
+        _hash = 0;
+        return _digits;
+    }
+};
@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <srcs/BigInt.hpp>
+
+namespace {
+
+const unsigned int kBase = 1000000000;
+const std::size_t kLimbDigits = 9;
+const unsigned int kPow10[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool is_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+// 上位桁から届く10進数字を9桁ずつ limb に詰めていく。
+// 桁数は最後まで分からないので、受け取った順 (上位から) に 9 桁単位で
+// 区切っておき、終端で余りの桁数ぶんだけ全体をずらして下位揃えに直す。
+// 追加メモリは値そのものの limb 配列だけで済む。
+class DecimalAccumulator {
+ public:
+    DecimalAccumulator()
+        : _groups(), _current(0), _count(0), _sawDigit(false) {}
+
+    void push(char c) {
+        _sawDigit = true;
+        if (_groups.empty() && _count == 0 && c == '0') {
+            return;
+        }
+        _current = _current * 10 + static_cast<unsigned int>(c - '0');
+        if (++_count == kLimbDigits) {
+            _groups.push_back(_current);
+            _current = 0;
+            _count = 0;
+        }
+    }
+
+    bool sawDigit() const {
+        return _sawDigit;
+    }
+
+    void finish(BigInt::DigitVector& digits) {
+        BigInt::DigitType* groups = mutable_data(_groups);
+        std::reverse(groups, groups + _groups.size());
+        if (_count > 0) {
+            // value = groups * 10^count + current
+            unsigned long long factor = kPow10[_count];
+            unsigned long long carry = _current;
+            for (std::size_t i = 0; i < _groups.size(); ++i) {
+                unsigned long long cur = groups[i] * factor + carry;
+                groups[i] = static_cast<BigInt::DigitType>(cur % kBase);
+                carry = cur / kBase;
+            }
+            if (carry) {
+                _groups.push_back(static_cast<BigInt::DigitType>(carry));
+            }
+        }
+        if (_groups.empty()) {
+            _groups.push_back(0);
+        }
+        digits.swap(_groups);
+    }
+
+ private:
+    BigInt::DigitVector _groups;
+    unsigned int _current;
+    std::size_t _count;
+    bool _sawDigit;
+};
+
+std::size_t limb_width(BigInt::DigitType v) {
+    std::size_t w = 1;
+    while (w < kLimbDigits && v >= kPow10[w]) {
+        ++w;
+    }
+    return w;
+}
+
+// 出力は固定長バッファに 9 桁ずつ書き込み、溜まったら Sink に流す。
+template <typename Sink>
+class BlockWriter {
+ public:
+    BlockWriter(Sink& sink, std::size_t chunkSize)
+        : _sink(sink), _buffer(std::max(chunkSize, kLimbDigits)), _used(0) {}
+
+    void put(char c) {
+        if (_used == _buffer.size()) {
+            flush();
+        }
+        _buffer[_used++] = c;
+    }
+
+    void fill(char c, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            put(c);
+        }
+    }
+
+    void limb(BigInt::DigitType v, std::size_t width) {
+        if (_buffer.size() - _used < width) {
+            flush();
+        }
+        for (std::size_t i = width; i > 0; --i) {
+            _buffer[_used + i - 1] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        }
+        _used += width;
+    }
+
+    void flush() {
+        if (_used > 0) {
+            _sink.write(&_buffer[0], _used);
+            _used = 0;
+        }
+    }
+
+ private:
+    Sink& _sink;
+    std::vector<char> _buffer;
+    std::size_t _used;
+};
+
+struct StreambufSink {
+    explicit StreambufSink(std::ostream& os) : os(os) {}
+
+    void write(const char* data, std::size_t len) {
+        std::streamsize n = static_cast<std::streamsize>(len);
+        if (os.rdbuf()->sputn(data, n) != n) {
+            os.setstate(std::ios::badbit);
+        }
+    }
+
+    std::ostream& os;
+};
+
+struct FdSink {
+    explicit FdSink(int fd) : fd(fd) {}
+
+    void write(const char* data, std::size_t len) {
+        while (len > 0) {
+            ssize_t n = ::write(fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(
+                    std::string("BigInt write error: ") + std::strerror(errno));
+            }
+            data += n;
+            len -= static_cast<std::size_t>(n);
+        }
+    }
+
+    int fd;
+};
+
+template <typename Sink>
+void write_magnitude(const BigInt::DigitVector& digits,
+                     BlockWriter<Sink>& out) {
+    if (digits.empty()) {
+        out.put('0');
+        return;
+    }
+    out.limb(digits.back(), limb_width(digits.back()));
+    for (std::size_t i = digits.size() - 1; i > 0; --i) {
+        out.limb(digits[i - 1], kLimbDigits);
+    }
+}
+
+}  // namespace
+
+std::size_t BigInt::textLength() const {
+    if (isZero()) {
+        return 1;
+    }
+    return (_isNegative ? 1 : 0) + limb_width(_digits.back())
+        + kLimbDigits * (_digits.size() - 1);
+}
+
+std::istream& BigInt::readFrom(std::istream& is) {
+    std::istream::sentry sentry(is);
+    if (!sentry) {
+        return is;
+    }
+    // limb 数は読み終えるまで分からない (失敗したら 0 のまま)
+    BIGINT_STATS_NAMED_SCOPE(parseScope, PARSE, 0);
+    std::streambuf* buf = is.rdbuf();
+    typedef std::char_traits<char> Traits;
+
+    bool negative = false;
+    Traits::int_type c = buf->sgetc();
+    if (c == Traits::to_int_type('-') || c == Traits::to_int_type('+')) {
+        negative = (c == Traits::to_int_type('-'));
+        c = buf->snextc();
+    }
+    DecimalAccumulator acc;
+    while (!Traits::eq_int_type(c, Traits::eof())
+            && is_digit(Traits::to_char_type(c))) {
+        acc.push(Traits::to_char_type(c));
+        c = buf->snextc();
+    }
+    if (Traits::eq_int_type(c, Traits::eof())) {
+        is.setstate(std::ios::eofbit);
+    } else if (!is_space(Traits::to_char_type(c))) {
+        is.setstate(std::ios::failbit);
+        return is;
+    }
+    if (!acc.sawDigit()) {
+        is.setstate(std::ios::failbit);
+        return is;
+    }
+    BigInt result;
+    acc.finish(result._digits);
+    result._isNegative = negative;
+    result.normalize();
+    swap(result);
+    BIGINT_STATS_SET_LIMBS(parseScope, _digits.size());
+    return is;
+}
+
+void BigInt::readFromFd(int fd, std::size_t chunkSize) {
+    // limb 数は読み終えるまで分からない (失敗したら 0 のまま)
+    BIGINT_STATS_NAMED_SCOPE(parseScope, PARSE, 0);
+    std::vector<char> buffer(std::max<std::size_t>(chunkSize, 1));
+    DecimalAccumulator acc;
+    // 0: 先頭の空白, 1: 符号の直後, 2: 数字列, 3: 末尾の空白
+    int state = 0;
+    bool negative = false;
+    for (;;) {
+        ssize_t n = ::read(fd, &buffer[0], buffer.size());
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(
+                std::string("BigInt read error: ") + std::strerror(errno));
+        }
+        if (n == 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n; ++i) {
+            char c = buffer[i];
+            if (state == 0) {
+                if (is_space(c)) {
+                    continue;
+                }
+                state = 1;
+                if (c == '-' || c == '+') {
+                    negative = (c == '-');
+                    continue;
+                }
+            }
+            if (state == 1 || state == 2) {
+                if (is_digit(c)) {
+                    acc.push(c);
+                    state = 2;
+                    continue;
+                }
+                if (state == 2 && is_space(c)) {
+                    state = 3;
+                    continue;
+                }
+                throw std::invalid_argument("Invalid input for BigInt: non-digit character");
+            }
+            if (!is_space(c)) {
+                throw std::invalid_argument("Invalid input for BigInt: trailing characters");
+            }
+        }
+    }
+    if (!acc.sawDigit()) {
+        throw std::invalid_argument("Invalid input for BigInt: no digits");
+    }
+    BigInt result;
+    acc.finish(result._digits);
+    result._isNegative = negative;
+    result.normalize();
+    swap(result);
+    BIGINT_STATS_SET_LIMBS(parseScope, _digits.size());
+}
+
+std::ostream& BigInt::writeTo(std::ostream& os, std::size_t chunkSize) const {
+    std::ostream::sentry sentry(os);
+    if (!sentry) {
+        return os;
+    }
+    BIGINT_STATS_SCOPE(TO_STRING, _digits.size());
+    std::size_t len = textLength();
+    std::size_t width = os.width() > 0 ? static_cast<std::size_t>(os.width()) : 0;
+    std::size_t pad = width > len ? width - len : 0;
+    std::ios::fmtflags adjust = os.flags() & std::ios::adjustfield;
+    bool negative = _isNegative && !isZero();
+
+    StreambufSink sink(os);
+    BlockWriter<StreambufSink> out(sink, chunkSize);
+    if (adjust == std::ios::internal) {
+        if (negative) {
+            out.put('-');
+        }
+        out.fill(os.fill(), pad);
+    } else {
+        if (adjust != std::ios::left) {
+            out.fill(os.fill(), pad);
+        }
+        if (negative) {
+            out.put('-');
+        }
+    }
+    write_magnitude(_digits, out);
+    if (adjust == std::ios::left) {
+        out.fill(os.fill(), pad);
+    }
+    out.flush();
+    os.width(0);
+    return os;
+}
+
+void BigInt::writeToFd(int fd, std::size_t chunkSize) const {
+    BIGINT_STATS_SCOPE(TO_STRING, _digits.size());
+    FdSink sink(fd);
+    BlockWriter<FdSink> out(sink, chunkSize);
+    if (_isNegative && !isZero()) {
+        out.put('-');
+    }
+    write_magnitude(_digits, out);
+    out.flush();
+}
@@ -0,0 +1,53 @@
+#include <stdexcept>
+
+#include <srcs/BigInt.hpp>
+
+// make tune が生成するマシンごとの閾値。無ければ下の既定値を使う。
+#ifdef BIGINT_HAVE_TUNING_HEADER
+#include <bigint_tuning.hpp>
+#endif
+
+#ifndef BIGINT_MULTIPLY_THRESHOLD
+#define BIGINT_MULTIPLY_THRESHOLD 10
+#endif
+#ifndef BIGINT_DIVISION_THRESHOLD
+#define BIGINT_DIVISION_THRESHOLD 70
+#endif
+#ifndef BIGINT_RADIX_THRESHOLD
+#define BIGINT_RADIX_THRESHOLD 32
+#endif
+
+std::size_t BigInt::MULTIPLY_THRESHOLD = BIGINT_MULTIPLY_THRESHOLD;
+std::size_t BigInt::DIVISION_THRESHOLD = BIGINT_DIVISION_THRESHOLD;
+std::size_t BigInt::RADIX_THRESHOLD = BIGINT_RADIX_THRESHOLD;
+
+BigInt::Thresholds BigInt::thresholds() {
+    Thresholds t;
+    t.multiply = MULTIPLY_THRESHOLD;
+    t.division = DIVISION_THRESHOLD;
+    t.radix = RADIX_THRESHOLD;
+    return t;
+}
+
+BigInt::Thresholds BigInt::defaultThresholds() {
+    Thresholds t;
+    t.multiply = BIGINT_MULTIPLY_THRESHOLD;
+    t.division = BIGINT_DIVISION_THRESHOLD;
+    t.radix = BIGINT_RADIX_THRESHOLD;
+    return t;
+}
+
+// 実験用の実行時上書き。再帰が止まらなくなる値は弾く。
+// 演算中に値が変わると分割の前提が崩れるので、ロックではなく呼ぶ時機で守る。
+void BigInt::setThresholds(const Thresholds& t) {
+    if (t.multiply < 2 || t.division < 2 || t.radix < 1) {
+        throw std::invalid_argument("BigInt thresholds: value too small");
+    }
+    MULTIPLY_THRESHOLD = t.multiply;
+    DIVISION_THRESHOLD = t.division;
+    RADIX_THRESHOLD = t.radix;
+}
+
+void BigInt::resetThresholds() {
+    setThresholds(defaultThresholds());
+}
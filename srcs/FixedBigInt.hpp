@@ -0,0 +1,494 @@
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <srcs/BigInt.hpp>
+
+// 上限の決まった値向けの固定長版 BigInt。limb は BigInt と同じ 10^9 進で
+// N 個をオブジェクト内に持つので、ヒープ確保が無く配列にもそのまま詰められる。
+// 加減乗算の内側ループは N ごとにテンプレートで展開する。
+// 結果が N limb に収まらないときは std::overflow_error を投げる。
+template <std::size_t N>
+class FixedBigInt {
+ public:
+    typedef BigInt::DigitType DigitType;
+    static const std::size_t LIMBS = N;
+
+    FixedBigInt();
+    explicit FixedBigInt(int value);
+    explicit FixedBigInt(const std::string& str);
+    explicit FixedBigInt(const BigInt& value);
+    BigInt toBigInt() const;
+    std::string toString() const;
+
+    bool isZero() const;
+    bool isNegative() const;
+    std::size_t size() const;
+    FixedBigInt abs() const;
+
+    FixedBigInt& operator+=(const FixedBigInt& rhs);
+    FixedBigInt& operator-=(const FixedBigInt& rhs);
+    FixedBigInt& operator*=(const FixedBigInt& rhs);
+    FixedBigInt& operator/=(const FixedBigInt& rhs);
+    FixedBigInt& operator%=(const FixedBigInt& rhs);
+    FixedBigInt operator-() const;
+    FixedBigInt& operator++();
+    FixedBigInt operator++(int);
+    FixedBigInt& operator--();
+    FixedBigInt operator--(int);
+    static void divmod(const FixedBigInt& divided, const FixedBigInt& divisor,
+                       FixedBigInt& quotient, FixedBigInt& remainder);
+
+    int compare(const FixedBigInt& rhs) const;
+    int compare_abs(const FixedBigInt& rhs) const;
+    bool operator==(const FixedBigInt& rhs) const { return compare(rhs) == 0; }
+    bool operator!=(const FixedBigInt& rhs) const { return compare(rhs) != 0; }
+    bool operator<(const FixedBigInt& rhs) const { return compare(rhs) < 0; }
+    bool operator<=(const FixedBigInt& rhs) const { return compare(rhs) <= 0; }
+    bool operator>(const FixedBigInt& rhs) const { return compare(rhs) > 0; }
+    bool operator>=(const FixedBigInt& rhs) const { return compare(rhs) >= 0; }
+
+ private:
+    DigitType _limbs[N];
+    bool _isNegative;
+
+    void clear();
+    void normalizeSign();
+};
+
+namespace fixed_bigint_detail {
+
+const unsigned int BASE = 1000000000;
+
+// I から END-1 までを再帰テンプレートで展開した limb ループ
+template <std::size_t I, std::size_t END>
+struct Unroll {
+    static unsigned int add(unsigned int* a, const unsigned int* b, unsigned int carry) {
+        unsigned int s = a[I] + b[I] + carry;
+        carry = s >= BASE ? 1 : 0;
+        a[I] = carry ? s - BASE : s;
+        return Unroll<I + 1, END>::add(a, b, carry);
+    }
+
+    static unsigned int sub(unsigned int* a, const unsigned int* b, unsigned int borrow) {
+        unsigned int t = b[I] + borrow;
+        borrow = a[I] < t ? 1 : 0;
+        a[I] = borrow ? a[I] + BASE - t : a[I] - t;
+        return Unroll<I + 1, END>::sub(a, b, borrow);
+    }
+
+    static unsigned long long mulAddRow(unsigned int* r, unsigned long long ai,
+                                        const unsigned int* b, unsigned long long carry) {
+        unsigned long long cur = r[I] + ai * b[I] + carry;
+        r[I] = static_cast<unsigned int>(cur % BASE);
+        return Unroll<I + 1, END>::mulAddRow(r, ai, b, cur / BASE);
+    }
+
+    // r = a * d + carry (d < BASE)。最上位からの繰り上がりを返す
+    static unsigned long long mulSmall(unsigned int* r, const unsigned int* a,
+                                       unsigned long long d, unsigned long long carry) {
+        unsigned long long cur = a[I] * d + carry;
+        r[I] = static_cast<unsigned int>(cur % BASE);
+        return Unroll<I + 1, END>::mulSmall(r, a, d, cur / BASE);
+    }
+
+    // q = (rem * BASE^END + a) / d を上位 (END-1-I) から求め、余りを返す
+    static unsigned long long divSmall(unsigned int* q, const unsigned int* a,
+                                       unsigned long long d, unsigned long long rem) {
+        const std::size_t k = END - 1 - I;
+        unsigned long long cur = rem * BASE + a[k];
+        q[k] = static_cast<unsigned int>(cur / d);
+        return Unroll<I + 1, END>::divSmall(q, a, d, cur % d);
+    }
+
+    // 上位 (END-1-I) から比較する
+    static int compare(const unsigned int* a, const unsigned int* b) {
+        const std::size_t k = END - 1 - I;
+        if (a[k] != b[k]) {
+            return a[k] < b[k] ? -1 : 1;
+        }
+        return Unroll<I + 1, END>::compare(a, b);
+    }
+};
+
+template <std::size_t END>
+struct Unroll<END, END> {
+    static unsigned int add(unsigned int*, const unsigned int*, unsigned int carry) {
+        return carry;
+    }
+    static unsigned int sub(unsigned int*, const unsigned int*, unsigned int borrow) {
+        return borrow;
+    }
+    static unsigned long long mulAddRow(unsigned int*, unsigned long long,
+                                        const unsigned int*, unsigned long long carry) {
+        return carry;
+    }
+    static unsigned long long mulSmall(unsigned int*, const unsigned int*,
+                                       unsigned long long, unsigned long long carry) {
+        return carry;
+    }
+    static unsigned long long divSmall(unsigned int*, const unsigned int*,
+                                       unsigned long long, unsigned long long rem) {
+        return rem;
+    }
+    static int compare(const unsigned int*, const unsigned int*) {
+        return 0;
+    }
+};
+
+inline void overflow() {
+    throw std::overflow_error("FixedBigInt overflow");
+}
+
+}  // namespace fixed_bigint_detail
+
+template <std::size_t N>
+FixedBigInt<N>::FixedBigInt()
+    : _isNegative(false) {
+    clear();
+}
+
+template <std::size_t N>
+FixedBigInt<N>::FixedBigInt(int value)
+    : _isNegative(value < 0) {
+    clear();
+    unsigned long long v = value < 0
+        ? static_cast<unsigned long long>(-(static_cast<long long>(value)))
+        : static_cast<unsigned long long>(value);
+    for (std::size_t i = 0; v > 0; ++i) {
+        if (i == N) {
+            fixed_bigint_detail::overflow();
+        }
+        _limbs[i] = static_cast<DigitType>(v % fixed_bigint_detail::BASE);
+        v /= fixed_bigint_detail::BASE;
+    }
+}
+
+template <std::size_t N>
+FixedBigInt<N>::FixedBigInt(const std::string& str)
+    : _isNegative(false) {
+    *this = FixedBigInt(BigInt(str));
+}
+
+template <std::size_t N>
+FixedBigInt<N>::FixedBigInt(const BigInt& value)
+    : _isNegative(value._isNegative) {
+    clear();
+    std::size_t n = value._digits.size();
+    while (n > 0 && value._digits[n - 1] == 0) {
+        --n;
+    }
+    if (n > N) {
+        fixed_bigint_detail::overflow();
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        _limbs[i] = value._digits[i];
+    }
+    normalizeSign();
+}
+
+template <std::size_t N>
+BigInt FixedBigInt<N>::toBigInt() const {
+    BigInt res;
+    std::size_t n = size();
+    res._digits.assign(_limbs, _limbs + (n > 0 ? n : 1));
+    res._isNegative = _isNegative;
+    res.normalize();
+    return res;
+}
+
+template <std::size_t N>
+std::string FixedBigInt<N>::toString() const {
+    return toBigInt().toString();
+}
+
+template <std::size_t N>
+bool FixedBigInt<N>::isZero() const {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (_limbs[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t N>
+bool FixedBigInt<N>::isNegative() const {
+    return _isNegative;
+}
+
+// 0 でない最上位 limb までの個数
+template <std::size_t N>
+std::size_t FixedBigInt<N>::size() const {
+    std::size_t n = N;
+    while (n > 0 && _limbs[n - 1] == 0) {
+        --n;
+    }
+    return n;
+}
+
+template <std::size_t N>
+FixedBigInt<N> FixedBigInt<N>::abs() const {
+    FixedBigInt res(*this);
+    res._isNegative = false;
+    return res;
+}
+
+template <std::size_t N>
+FixedBigInt<N>& FixedBigInt<N>::operator+=(const FixedBigInt& rhs) {
+    using fixed_bigint_detail::Unroll;
+    if (_isNegative == rhs._isNegative) {
+        if (Unroll<0, N>::add(_limbs, rhs._limbs, 0)) {
+            fixed_bigint_detail::overflow();
+        }
+    } else if (compare_abs(rhs) >= 0) {
+        Unroll<0, N>::sub(_limbs, rhs._limbs, 0);
+    } else {
+        FixedBigInt tmp(rhs);
+        Unroll<0, N>::sub(tmp._limbs, _limbs, 0);
+        *this = tmp;
+    }
+    normalizeSign();
+    return *this;
+}
+
+template <std::size_t N>
+FixedBigInt<N>& FixedBigInt<N>::operator-=(const FixedBigInt& rhs) {
+    return *this += -rhs;
+}
+
+template <std::size_t N>
+FixedBigInt<N>& FixedBigInt<N>::operator*=(const FixedBigInt& rhs) {
+    using fixed_bigint_detail::Unroll;
+    std::size_t na = size();
+    // 2N limb の作業領域に行ごとの積和を足し込み、上位 N limb が 0 か確かめる
+    DigitType res[2 * N];
+    for (std::size_t i = 0; i < 2 * N; ++i) {
+        res[i] = 0;
+    }
+    for (std::size_t i = 0; i < na; ++i) {
+        if (_limbs[i] == 0) {
+            continue;
+        }
+        res[i + N] = static_cast<DigitType>(
+            Unroll<0, N>::mulAddRow(res + i, _limbs[i], rhs._limbs, 0));
+    }
+    for (std::size_t i = N; i < 2 * N; ++i) {
+        if (res[i] != 0) {
+            fixed_bigint_detail::overflow();
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        _limbs[i] = res[i];
+    }
+    _isNegative = (_isNegative != rhs._isNegative);
+    normalizeSign();
+    return *this;
+}
+
+template <std::size_t N>
+FixedBigInt<N>& FixedBigInt<N>::operator/=(const FixedBigInt& rhs) {
+    FixedBigInt q, r;
+    divmod(*this, rhs, q, r);
+    *this = q;
+    return *this;
+}
+
+template <std::size_t N>
+FixedBigInt<N>& FixedBigInt<N>::operator%=(const FixedBigInt& rhs) {
+    FixedBigInt q, r;
+    divmod(*this, rhs, q, r);
+    *this = r;
+    return *this;
+}
+
+template <std::size_t N>
+FixedBigInt<N> FixedBigInt<N>::operator-() const {
+    FixedBigInt res(*this);
+    res._isNegative = !_isNegative;
+    res.normalizeSign();
+    return res;
+}
+
+template <std::size_t N>
+FixedBigInt<N>& FixedBigInt<N>::operator++() {
+    return *this += FixedBigInt(1);
+}
+
+template <std::size_t N>
+FixedBigInt<N> FixedBigInt<N>::operator++(int) {
+    FixedBigInt temp(*this);
+    ++(*this);
+    return temp;
+}
+
+template <std::size_t N>
+FixedBigInt<N>& FixedBigInt<N>::operator--() {
+    return *this -= FixedBigInt(1);
+}
+
+template <std::size_t N>
+FixedBigInt<N> FixedBigInt<N>::operator--(int) {
+    FixedBigInt temp(*this);
+    --(*this);
+    return temp;
+}
+
+// BigInt::schoolbook_division と同じ Knuth の算法 D を固定長配列上で行う。
+// 商は 0 方向への切り捨て、剰余の符号は被除数に合わせる。
+// 正規化・逆正規化と 1 limb の除数は N limb 全体を Unroll で回す
+// (上位の 0 の limb は結果を変えない)。q_hat の積和は除数の長さ n と
+// 位置 j が実行時に決まるので普通のループのまま。
+template <std::size_t N>
+void FixedBigInt<N>::divmod(const FixedBigInt& divided, const FixedBigInt& divisor,
+                            FixedBigInt& quotient, FixedBigInt& remainder) {
+    using fixed_bigint_detail::Unroll;
+    const unsigned long long base = fixed_bigint_detail::BASE;
+    std::size_t n = divisor.size();
+    if (n == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    FixedBigInt q, r;
+    if (divided.compare_abs(divisor) < 0) {
+        r = divided;
+    } else if (n == 1) {
+        r._limbs[0] = static_cast<DigitType>(
+            Unroll<0, N>::divSmall(q._limbs, divided._limbs, divisor._limbs[0], 0));
+    } else {
+        std::size_t m = divided.size() - n;
+        unsigned long long d = base / (divisor._limbs[n - 1] + 1ULL);
+        DigitType u[N + 1];
+        DigitType v[N];
+        u[N] = static_cast<DigitType>(Unroll<0, N>::mulSmall(u, divided._limbs, d, 0));
+        Unroll<0, N>::mulSmall(v, divisor._limbs, d, 0);
+        unsigned long long v_top = v[n - 1];
+        unsigned long long v_sec = v[n - 2];
+        for (std::size_t j = m + 1; j-- > 0; ) {
+            unsigned long long num = u[j + n] * base + u[j + n - 1];
+            unsigned long long q_hat = num / v_top;
+            unsigned long long r_hat = num % v_top;
+            while (q_hat >= base || q_hat * v_sec > r_hat * base + u[j + n - 2]) {
+                --q_hat;
+                r_hat += v_top;
+                if (r_hat >= base) {
+                    break;
+                }
+            }
+            long long borrow = 0;
+            unsigned long long mul_carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                unsigned long long prod = q_hat * v[i] + mul_carry;
+                mul_carry = prod / base;
+                long long sub = static_cast<long long>(u[j + i])
+                    - static_cast<long long>(prod % base) - borrow;
+                borrow = sub < 0 ? 1 : 0;
+                u[j + i] = static_cast<DigitType>(sub < 0 ? sub + base : sub);
+            }
+            long long top = static_cast<long long>(u[j + n])
+                - static_cast<long long>(mul_carry) - borrow;
+            if (top < 0) {
+                --q_hat;
+                unsigned long long add_carry = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    unsigned long long sum = u[j + i] + v[i] + add_carry;
+                    u[j + i] = static_cast<DigitType>(sum % base);
+                    add_carry = sum / base;
+                }
+                top += static_cast<long long>(add_carry);
+            }
+            u[j + n] = static_cast<DigitType>(top);
+            q._limbs[j] = static_cast<DigitType>(q_hat);
+        }
+        // 剰余は u の下位 n limb にあり、その上は 0 になっている
+        Unroll<0, N>::divSmall(r._limbs, u, d, 0);
+    }
+    q._isNegative = (divided._isNegative != divisor._isNegative);
+    r._isNegative = divided._isNegative;
+    q.normalizeSign();
+    r.normalizeSign();
+    quotient = q;
+    remainder = r;
+}
+
+template <std::size_t N>
+int FixedBigInt<N>::compare(const FixedBigInt& rhs) const {
+    if (_isNegative != rhs._isNegative) {
+        return _isNegative ? -1 : 1;
+    }
+    int c = compare_abs(rhs);
+    return _isNegative ? -c : c;
+}
+
+template <std::size_t N>
+int FixedBigInt<N>::compare_abs(const FixedBigInt& rhs) const {
+    return fixed_bigint_detail::Unroll<0, N>::compare(_limbs, rhs._limbs);
+}
+
+template <std::size_t N>
+void FixedBigInt<N>::clear() {
+    for (std::size_t i = 0; i < N; ++i) {
+        _limbs[i] = 0;
+    }
+}
+
+template <std::size_t N>
+void FixedBigInt<N>::normalizeSign() {
+    if (isZero()) {
+        _isNegative = false;
+    }
+}
+
+template <std::size_t N>
+const FixedBigInt<N> operator+(const FixedBigInt<N>& lhs, const FixedBigInt<N>& rhs) {
+    FixedBigInt<N> result(lhs);
+    result += rhs;
+    return result;
+}
+
+template <std::size_t N>
+const FixedBigInt<N> operator-(const FixedBigInt<N>& lhs, const FixedBigInt<N>& rhs) {
+    FixedBigInt<N> result(lhs);
+    result -= rhs;
+    return result;
+}
+
+template <std::size_t N>
+const FixedBigInt<N> operator*(const FixedBigInt<N>& lhs, const FixedBigInt<N>& rhs) {
+    FixedBigInt<N> result(lhs);
+    result *= rhs;
+    return result;
+}
+
+template <std::size_t N>
+const FixedBigInt<N> operator/(const FixedBigInt<N>& lhs, const FixedBigInt<N>& rhs) {
+    FixedBigInt<N> result(lhs);
+    result /= rhs;
+    return result;
+}
+
+template <std::size_t N>
+const FixedBigInt<N> operator%(const FixedBigInt<N>& lhs, const FixedBigInt<N>& rhs) {
+    FixedBigInt<N> result(lhs);
+    result %= rhs;
+    return result;
+}
+
+template <std::size_t N>
+std::ostream& operator<<(std::ostream& os, const FixedBigInt<N>& num) {
+    return os << num.toBigInt();
+}
+
+template <std::size_t N>
+std::istream& operator>>(std::istream& is, FixedBigInt<N>& num) {
+    BigInt value;
+    if (is >> value) {
+        try {
+            num = FixedBigInt<N>(value);
+        } catch (const std::overflow_error&) {
+            is.setstate(std::ios::failbit);
+        }
+    }
+    return is;
+}
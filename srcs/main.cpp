@@ -1,6 +1,867 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tr1/unordered_map>
 
+#include <srcs/BigDecimal.hpp>
 #include <srcs/BigInt.hpp>
+#include <srcs/BigIntBatch.hpp>
+#include <srcs/BigIntRNS.hpp>
+#include <srcs/FixedBigInt.hpp>
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace {
+
+int g_failures = 0;
+
+// 失敗したものだけ内容を出す
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        ++g_failures;
+        std::cout << "  FAIL: " << what << std::endl;
+    }
+}
+
+void run_test(const char* name, void (*test)()) {
+    int before = g_failures;
+    test();
+    std::cout << name << ": " << (g_failures == before ? "ok" : "FAILED") << std::endl;
+}
+
+// seed で決まる n 桁の 10 進数字列 (先頭は 0 でない)
+std::string digit_string(std::size_t n, unsigned int seed) {
+    std::string s(n, '0');
+    for (std::size_t i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        s[i] = static_cast<char>('0' + (seed >> 16) % 10);
+    }
+    if (n > 0 && s[0] == '0') {
+        s[0] = '1';
+    }
+    return s;
+}
+
+void check_stream_round_trip(const std::string& text, std::size_t chunkSize) {
+    BigInt x(text);
+    std::ostringstream oss;
+    x.writeTo(oss, chunkSize);
+    check(oss.str() == x.toString(), "writeTo " + text.substr(0, 20));
+    check(x.textLength() == x.toString().size(), "textLength " + text.substr(0, 20));
+    std::istringstream iss(oss.str());
+    BigInt y;
+    y.readFrom(iss);
+    check(!iss.fail() && y == x, "readFrom " + text.substr(0, 20));
+}
+
+void test_stream() {
+    const std::string big = digit_string(5000, 26);
+    const std::size_t chunks[] = { 1, 7, 9, 10, BigInt::STREAM_CHUNK_SIZE };
+    for (std::size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+        check_stream_round_trip("0", chunks[i]);
+        check_stream_round_trip("-1", chunks[i]);
+        check_stream_round_trip("1000000000", chunks[i]);
+        check_stream_round_trip(big, chunks[i]);
+        check_stream_round_trip("-" + big, chunks[i]);
+    }
+
+    // 空白で区切られた連続読み込み、先頭の 0、不正な入力
+    std::istringstream in("  -000123 +45\n0007 12x");
+    BigInt a, b, c, d;
+    in >> a >> b >> c;
+    check(a == BigInt(-123) && b == BigInt(45) && c == BigInt(7), "operator>> sequence");
+    in >> d;
+    check(in.fail(), "operator>> rejects 12x");
+
+    // 幅と詰め方は std::ostream の整数と同じ
+    std::ostringstream padded;
+    padded << std::setw(6) << std::setfill('0') << std::internal << BigInt(-42) << "|"
+           << std::setw(5) << std::setfill(' ') << std::left << BigInt(7) << "|";
+    check(padded.str() == "-00042|7    |", "writeTo padding");
+
+    // fd 版は一時ファイルで往復させる
+    std::FILE* file = std::tmpfile();
+    if (file == 0) {
+        check(false, "tmpfile");
+        return;
+    }
+    int fd = fileno(file);
+    BigInt x("-" + big);
+    x.writeToFd(fd, 100);
+    check(::write(fd, " \n", 2) == 2, "write trailer");
+    lseek(fd, 0, SEEK_SET);
+    BigInt y;
+    y.readFromFd(fd, 13);
+    check(y == x, "writeToFd/readFromFd");
+    std::fclose(file);
+}
+
+bool parse_throws(const std::string& text, int base) {
+    try {
+        BigInt x(text, base);
+        (void)x;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+// 10 進の text を base 進に直して戻すと元に戻り、2 の冪と一般の基数で一致する
+void check_radix_round_trips(const std::string& text) {
+    const BigInt x(text);
+    for (int base = 2; base <= 36; ++base) {
+        std::string s = x.toString(base);
+        if (BigInt(s, base) != x) {
+            check(false, "radix round trip " + text.substr(0, 20) + " base " + BigInt(base).toString());
+        }
+    }
+}
+
+void test_radix() {
+    check(BigInt("ff", 16) == BigInt(255) && BigInt("FF", 16) == BigInt(255), "parse hex");
+    check(BigInt("-777", 8) == BigInt(-511), "parse octal");
+    check(BigInt("+z", 36) == BigInt(35) && BigInt("000101", 2) == BigInt(5), "parse sign and zeros");
+    check(BigInt(10).toString(2) == "1010" && BigInt(-255).toString(16) == "-ff", "print small");
+    check(BigInt::pow(BigInt(2), 64).toString(16) == "10000000000000000", "2^64 in hex");
+    check(BigInt::pow(BigInt(3), 40).toString(3) == "1" + std::string(40, '0'), "3^40 in base 3");
+    // 約 5300 limb。キャッシュしない大きさの段 (4096 limb 超) も通る
+    const BigInt big = BigInt::pow(BigInt(3), 100000) + BigInt(1);
+    check(big.toString(3) == "1" + std::string(99999, '0') + "1"
+          && BigInt(big.toString(7), 7) == big, "3^100000 + 1 past the power cache");
+    check(BigInt("-0", 16).toString(16) == "0", "-0");
+    check(parse_throws("19", 8) && parse_throws("", 16) && parse_throws("-", 2)
+          && parse_throws("1", 1) && parse_throws("1", 37), "invalid input");
+
+    // 3000 桁は RADIX_THRESHOLD (limb 数) を超えて分割統治の側を通る
+    const std::size_t lengths[] = { 1, 9, 10, 40, 400, 3000 };
+    for (std::size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        check_radix_round_trips(digit_string(lengths[i], 27 + i));
+        check_radix_round_trips("-" + digit_string(lengths[i], 270 + i));
+    }
+    // 閾値を最小にして、小さい値でも再帰の境目を全部通す
+    BigInt::Thresholds t = BigInt::thresholds();
+    t.radix = 1;
+    BigInt::setThresholds(t);
+    for (std::size_t n = 1; n <= 60; n += 7) {
+        check_radix_round_trips(digit_string(n, 2700 + n));
+    }
+    check_radix_round_trips(std::string(300, '9'));
+    BigInt::resetThresholds();
+}
+
+int sign_of(int c) {
+    return c < 0 ? -1 : (c > 0 ? 1 : 0);
+}
+
+void test_compare() {
+    // 昇順に並べた値。隣どうしは符号・limb 数・上位 limb・下位 limb のどれかだけが違う
+    const std::string sorted[] = {
+        "-1000000000000000000", "-999999999999999999", "-1000000001", "-1000000000",
+        "-2", "-1", "0", "1", "2", "999999999", "1000000000", "1000000001",
+        "2000000000", "999999999999999999", "1000000000000000000"
+    };
+    const std::size_t n = sizeof(sorted) / sizeof(sorted[0]);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            BigInt a(sorted[i]), b(sorted[j]);
+            int expected = i < j ? -1 : (i > j ? 1 : 0);
+            const std::string what = sorted[i] + " vs " + sorted[j];
+            check(sign_of(a.compare(b)) == expected, "compare " + what);
+            check((a < b) == (expected < 0) && (a <= b) == (expected <= 0)
+                  && (a > b) == (expected > 0) && (a >= b) == (expected >= 0)
+                  && (a == b) == (expected == 0) && (a != b) == (expected != 0),
+                  "operators " + what);
+            check(sign_of(a.compare_abs(b)) == sign_of(a.abs().compare(b.abs())),
+                  "compare_abs " + what);
+        }
+    }
+    // 0 の表現の違いは比較に出ない
+    check(BigInt().compare(BigInt(0)) == 0 && BigInt("-0").compare(BigInt()) == 0
+          && (BigInt(5) - BigInt(5)).compare(BigInt()) == 0, "zero representations");
+    check(BigInt(-7).compare_abs(BigInt(7)) == 0, "compare_abs ignores sign");
+}
+
+void test_divmod() {
+    const std::size_t lengths[] = { 1, 9, 10, 100, 700, 2000 };
+    const std::size_t n = sizeof(lengths) / sizeof(lengths[0]);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            for (int signs = 0; signs < 4; ++signs) {
+                BigInt a(digit_string(lengths[i], 29 + i));
+                BigInt b(digit_string(lengths[j], 290 + j));
+                if (signs & 1) {
+                    a = -a;
+                }
+                if (signs & 2) {
+                    b = -b;
+                }
+                BigInt q, r;
+                BigInt::divmod(a, b, q, r);
+                const std::string what = " " + a.toString().substr(0, 10) + " / "
+                    + b.toString().substr(0, 10);
+                // 商は 0 方向に切り捨て、剰余は被除数と同じ符号
+                check(q * b + r == a && r.compare_abs(b) < 0
+                      && (r.isZero() || r.isNegative() == a.isNegative()), "divmod" + what);
+                check(q == a / b && r == a % b, "divmod matches / and %" + what);
+            }
+        }
+    }
+    bool thrown = false;
+    try {
+        BigInt q, r;
+        BigInt::divmod(BigInt(1), BigInt(), q, r);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    check(thrown, "divmod by zero");
+}
+
+bool same_thresholds(const BigInt::Thresholds& a, const BigInt::Thresholds& b) {
+    return a.multiply == b.multiply && a.division == b.division && a.radix == b.radix;
+}
+
+void test_thresholds() {
+    const BigInt::Thresholds defaults = BigInt::defaultThresholds();
+    check(same_thresholds(BigInt::thresholds(), defaults), "starts at defaults");
+
+    // 再帰が止まらなくなる値は弾き、今の値を変えない
+    BigInt::Thresholds bad = defaults;
+    bad.multiply = 1;
+    bool thrown = false;
+    try {
+        BigInt::setThresholds(bad);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown && same_thresholds(BigInt::thresholds(), defaults), "rejects multiply 1");
+
+    // 閾値は速さだけを変え、結果は変えない
+    const BigInt a(digit_string(3000, 30)), b(digit_string(1400, 300));
+    const BigInt product = a * b;
+    const BigInt quotient = a * a / b;
+    const BigInt::Thresholds settings[] = {
+        { 2, 2, 1 }, { 3, 5, 2 }, { 1000, 1000, 1000 }
+    };
+    for (std::size_t i = 0; i < sizeof(settings) / sizeof(settings[0]); ++i) {
+        BigInt::setThresholds(settings[i]);
+        check(same_thresholds(BigInt::thresholds(), settings[i]), "setThresholds");
+        check(a * b == product && a * a / b == quotient
+              && BigInt(a.toString()) == a, "results independent of thresholds");
+    }
+    BigInt::resetThresholds();
+    check(same_thresholds(BigInt::thresholds(), defaults), "resetThresholds");
+}
+
+void test_stats() {
+    const std::string text = digit_string(9000, 31);
+    const BigInt a(digit_string(900, 310)), b(digit_string(900, 311));
+    BigIntStats::reset();
+    std::istringstream in(text);
+    BigInt x;
+    in >> x;
+    BigInt product = a * b;
+    const BigIntStats::Counter& parse = BigIntStats::counter(BigIntStats::PARSE);
+    const BigIntStats::Counter& karatsuba = BigIntStats::counter(BigIntStats::KARATSUBA_MULTIPLY);
+    std::string json = BigIntStats::toJson();
+    if (BigIntStats::enabled()) {
+        // 9000 桁 = 1000 limb は log2 の bucket 9 に入る
+        check(parse.calls == 1 && parse.histogram[9] == 1, "parse recorded with its limb count");
+        check(karatsuba.calls > 0 && karatsuba.histogram[6] > 0, "karatsuba recorded");
+        check(BigIntStats::allocations().count > 0
+              && BigIntStats::allocations().peakBytes >= BigIntStats::allocations().liveBytes,
+              "allocations recorded");
+        check(json.find("\"parse\": {\"calls\": 1,") != std::string::npos, "toJson");
+        BigIntStats::reset();
+        check(parse.calls == 0 && karatsuba.calls == 0
+              && BigIntStats::allocations().count == 0, "reset");
+    } else {
+        // フックは空のマクロなので何も数えない
+        check(parse.calls == 0 && karatsuba.calls == 0, "disabled stats stay zero");
+        check(json.find("\"enabled\": false") != std::string::npos, "toJson disabled");
+    }
+    check(x.toString() == text && !product.isZero(), "values unaffected");
+    check(std::string(BigIntStats::name(BigIntStats::BURNIKEL_ZIEGLER)) == "burnikel_ziegler",
+          "algorithm names");
+}
+
+template <typename T>
+std::string integer_text(T value) {
+    std::ostringstream oss;
+    if (std::numeric_limits<T>::is_signed) {
+        oss << static_cast<long long>(value);
+    } else {
+        oss << static_cast<unsigned long long>(value);
+    }
+    return oss.str();
+}
+
+// 型ごとの最小・最大と 0, 1 がその値の BigInt になるか
+template <typename T>
+void check_integer_type(const char* type) {
+    const T values[] = {
+        std::numeric_limits<T>::min(), T(0), T(1), std::numeric_limits<T>::max()
+    };
+    for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        BigInt x(values[i]);
+        check(x.toString() == integer_text(values[i]),
+              std::string("BigInt(") + type + ") " + integer_text(values[i]));
+    }
+}
+
+void test_integer_constructors() {
+    // どの組み込み整数型からも曖昧にならずに作れること自体がコンパイル時の検査
+    check_integer_type<bool>("bool");
+    check_integer_type<char>("char");
+    check_integer_type<signed char>("signed char");
+    check_integer_type<unsigned char>("unsigned char");
+    check_integer_type<wchar_t>("wchar_t");
+    check_integer_type<short>("short");
+    check_integer_type<unsigned short>("unsigned short");
+    check_integer_type<int>("int");
+    check_integer_type<unsigned int>("unsigned int");
+    check_integer_type<long>("long");
+    check_integer_type<unsigned long>("unsigned long");
+    check_integer_type<long long>("long long");
+    check_integer_type<unsigned long long>("unsigned long long");
+    check_integer_type<std::size_t>("size_t");
+    check_integer_type<std::ptrdiff_t>("ptrdiff_t");
+    check(BigInt(5u) == BigInt(5) && BigInt(5L) == BigInt(5)
+          && BigInt(5UL) == BigInt(5) && BigInt(-5LL) == BigInt(-5), "literal suffixes");
+}
+
+bool int64_throws(const BigInt& x, bool isSigned) {
+    try {
+        if (isSigned) {
+            x.toInt64();
+        } else {
+            x.toUint64();
+        }
+    } catch (const std::overflow_error&) {
+        return true;
+    }
+    return false;
+}
+
+void test_conversions() {
+    const BigInt two64 = BigInt::pow(BigInt(2), 64);
+    const BigInt two53 = BigInt::pow(BigInt(2), 53);
+
+    check(BigInt(0).digitCount() == 1 && BigInt(-9).digitCount() == 1
+          && BigInt(10).digitCount() == 2 && BigInt(999999999).digitCount() == 9
+          && BigInt(1000000000).digitCount() == 10, "digitCount small");
+    check(BigInt::pow(BigInt(10), 100).digitCount() == 101
+          && (-BigInt::pow(BigInt(10), 100) + BigInt(1)).digitCount() == 100, "digitCount large");
+    check(std::fabs(BigInt::pow(BigInt(2), 1000).log2Approx() - 1000) < 1e-9
+          && std::fabs(BigInt::pow(BigInt(10), 500).log10Approx() - 500) < 1e-9
+          && std::fabs(BigInt(1000).log10Approx() - 3) < 1e-12, "log estimates");
+
+    // 最近接偶数丸め: 2^53 + 1 と 2^64 + 2^11 はちょうど中間
+    check((two53 + BigInt(1)).toDouble() == std::ldexp(1.0, 53)
+          && (two53 + BigInt(3)).toDouble() == std::ldexp(1.0, 53) + 4, "toDouble ties to even");
+    check((two64 + BigInt(2048)).toDouble() == std::ldexp(1.0, 64)
+          && (two64 + BigInt(2049)).toDouble() == std::ldexp(1.0, 64) + 4096
+          && (-two64 - BigInt(6144)).toDouble() == -(std::ldexp(1.0, 64) + 8192),
+          "toDouble ties across limbs");
+    check(BigInt::pow(BigInt(10), 309).toDouble() == std::numeric_limits<double>::infinity()
+          && (-BigInt::pow(BigInt(10), 400)).toDouble() == -std::numeric_limits<double>::infinity(),
+          "toDouble overflow");
+    // strtod は正しく丸めるので、それと一致するか
+    const std::size_t lengths[] = { 1, 16, 17, 19, 20, 40, 300, 308 };
+    for (std::size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        const std::string text = digit_string(lengths[i], 39 + i);
+        check(BigInt(text).toDouble() == std::strtod(text.c_str(), 0), "toDouble " + text.substr(0, 20));
+    }
+
+    check(BigInt(1e22).toString() == "10000000000000000000000" && BigInt(-2.9) == BigInt(-2)
+          && BigInt(0.5).isZero() && BigInt(std::ldexp(1.0, 100)) == BigInt::pow(BigInt(2), 100)
+          && BigInt(-std::ldexp(3.0, 70)) == -BigInt::pow(BigInt(2), 70) * BigInt(3),
+          "BigInt(double)");
+    int thrown = 0;
+    const double invalid[] = {
+        std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity()
+    };
+    for (std::size_t i = 0; i < 3; ++i) {
+        try {
+            BigInt x(invalid[i]);
+            (void)x;
+        } catch (const std::invalid_argument&) {
+            ++thrown;
+        }
+    }
+    check(thrown == 3, "BigInt(double) rejects NaN and infinity");
+
+    const long long minInt64 = std::numeric_limits<long long>::min();
+    const long long maxInt64 = std::numeric_limits<long long>::max();
+    const unsigned long long maxUint64 = std::numeric_limits<unsigned long long>::max();
+    check(BigInt(minInt64).toInt64() == minInt64 && BigInt(maxInt64).toInt64() == maxInt64
+          && BigInt(-1).toInt64() == -1 && BigInt().toInt64() == 0, "toInt64");
+    check(BigInt(maxUint64).toUint64() == maxUint64 && BigInt("-0").toUint64() == 0, "toUint64");
+    check(int64_throws(BigInt(maxInt64) + BigInt(1), true)
+          && int64_throws(BigInt(minInt64) - BigInt(1), true)
+          && int64_throws(two64, false) && int64_throws(BigInt(-1), false), "64-bit overflow");
+}
+
+void test_batch() {
+    // 5 limb に収まる値の組。最大値や 0 で繰り上がり・借りの端を通す
+    const std::size_t count = 6;
+    const std::size_t limbs = 5;
+    const BigInt max = BigInt::pow(BigInt(10), 45) - BigInt(1);
+    const BigInt xs[count] = {
+        max, BigInt(0), BigInt(digit_string(45, 33)), BigInt(digit_string(20, 34)),
+        BigInt(1000000000), max
+    };
+    const BigInt ys[count] = {
+        max, BigInt(0), BigInt(digit_string(30, 330)), BigInt(1),
+        BigInt(999999999), BigInt(1)
+    };
+    BigIntBatch a(count, limbs), b(count, limbs);
+    for (std::size_t i = 0; i < count; ++i) {
+        a.set(i, xs[i]);
+        b.set(i, ys[i]);
+    }
+    BigIntBatch sum = a.add(b);
+    BigIntBatch product = a.mul(b);
+    BigIntBatch diff = a.sub(b);
+    const BigInt modulus(digit_string(12, 333));
+    BigIntBatch rem = a.mod(modulus);
+    check(sum.limbs() == limbs + 1 && product.limbs() == 2 * limbs, "result widths");
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string what = " at " + BigInt(static_cast<int>(i)).toString();
+        check(a.get(i) == xs[i], "set/get" + what);
+        check(sum.get(i) == xs[i] + ys[i], "add" + what);
+        check(diff.get(i) == xs[i] - ys[i], "sub" + what);
+        check(product.get(i) == xs[i] * ys[i], "mul" + what);
+        check(rem.get(i) == xs[i] % modulus, "mod" + what);
+    }
+
+    // 入らない値・負の値・負の差・形の違うバッチは例外
+    int thrown = 0;
+    try {
+        a.set(0, max + BigInt(1));
+    } catch (const std::overflow_error&) {
+        ++thrown;
+    }
+    try {
+        a.set(0, BigInt(-1));
+    } catch (const std::invalid_argument&) {
+        ++thrown;
+    }
+    try {
+        b.sub(a);
+    } catch (const std::range_error&) {
+        ++thrown;
+    }
+    try {
+        a.add(BigIntBatch(count + 1, limbs));
+    } catch (const std::invalid_argument&) {
+        ++thrown;
+    }
+    try {
+        a.set(count, BigInt(1));
+    } catch (const std::out_of_range&) {
+        ++thrown;
+    }
+    try {
+        a.get(count);
+    } catch (const std::out_of_range&) {
+        ++thrown;
+    }
+    try {
+        a.row(limbs);
+    } catch (const std::out_of_range&) {
+        ++thrown;
+    }
+    check(thrown == 7, "batch errors");
+
+    // 要素 0 個のバッチも演算できる
+    BigIntBatch empty(0, limbs);
+    check(empty.add(empty).count() == 0 && empty.mul(empty).mod(modulus).count() == 0,
+          "empty batch");
+}
+
+// コピーしてから片方を書き換えても、もう片方は元の値のまま
+void check_copy_independent(int op) {
+    const std::string text = digit_string(500, 34);
+    BigInt original(text);
+    BigInt copy(original);
+    BigInt assigned;
+    assigned = original;
+    BigInt other(7);
+    switch (op) {
+        case 0: copy += original; break;
+        case 1: copy -= BigInt(1); break;
+        case 2: copy *= copy; break;
+        case 3: copy /= BigInt(3); break;
+        case 4: copy %= BigInt(1000); break;
+        case 5: ++copy; break;
+        case 6: --copy; break;
+        case 7: copy.swap(other); break;
+        case 8: { std::istringstream in("-5"); in >> copy; break; }
+        default: copy = -copy; break;
+    }
+    const std::string what = " after op " + BigInt(op).toString();
+    check(original.toString() == text, "original unchanged" + what);
+    check(assigned.toString() == text, "assigned copy unchanged" + what);
+    check(copy != original, "copy changed" + what);
+}
+
+#if !defined(BIGINT_COW) || defined(BIGINT_COW_ATOMIC)
+const BigInt* g_shared = 0;
+char g_copy_failed;
+
+void* copy_shared(void*) {
+    for (int i = 0; i < 2000; ++i) {
+        BigInt copy(*g_shared);
+        ++copy;
+        if (copy == *g_shared) {
+            return &g_copy_failed;
+        }
+    }
+    return 0;
+}
+#endif
+
+void test_copy_on_write() {
+    for (int op = 0; op < 10; ++op) {
+        check_copy_independent(op);
+    }
+    BigInt a(digit_string(100, 340));
+    BigInt b(a);
+    b -= a;
+    check(b.isZero() && a == BigInt(digit_string(100, 340)), "a - copy of a");
+
+#if !defined(BIGINT_COW) || defined(BIGINT_COW_ATOMIC)
+    // 同じ値から複数スレッドでコピーを作って書き換える (COW=1 はスレッド間で共有不可)
+    const BigInt shared(digit_string(300, 341));
+    g_shared = &shared;
+    pthread_t threads[4];
+    for (int i = 0; i < 4; ++i) {
+        pthread_create(&threads[i], 0, copy_shared, 0);
+    }
+    bool ok = true;
+    for (int i = 0; i < 4; ++i) {
+        void* result;
+        pthread_join(threads[i], &result);
+        ok = ok && result == 0;
+    }
+    check(ok && shared == BigInt(digit_string(300, 341)), "copies across threads");
+#endif
+}
+
+void test_primes() {
+    const char* primes[] = {
+        "2", "3", "5", "7", "65537", "999999937", "1000000007",
+        "2305843009213693951",                       // 2^61 - 1
+        "618970019642690137449562111",               // 2^89 - 1
+        "170141183460469231731687303715884105727"    // 2^127 - 1
+    };
+    for (std::size_t i = 0; i < sizeof(primes) / sizeof(primes[0]); ++i) {
+        check(BigInt(primes[i]).isProbablePrime(), std::string("prime ") + primes[i]);
+    }
+    const char* composites[] = {
+        "0", "1", "-7", "4", "999999999", "4294967297",
+        // Carmichael 数
+        "561", "1105", "1729", "41041", "825265", "3215031751",
+        "1296198694153288947529",                    // (6k+1)(12k+1)(18k+1), k = 1000051
+        // 底 2 の強擬素数 (3825123056546413051 は底 2 から 23 まで通る)
+        "2047", "3277", "4033", "3825123056546413051",
+        // 強 Lucas 擬素数
+        "5459", "5777", "10877",
+        "4611686014132420609"                        // (2^31 - 1)^2
+    };
+    for (std::size_t i = 0; i < sizeof(composites) / sizeof(composites[0]); ++i) {
+        check(!BigInt(composites[i]).isProbablePrime(), std::string("composite ") + composites[i]);
+    }
+    check(!(BigInt(primes[8]) * BigInt(primes[9])).isProbablePrime(), "semiprime");
+
+    const BigInt e18 = BigInt::pow(BigInt(10), 18);
+    const BigInt e100 = BigInt::pow(BigInt(10), 100);
+    check(BigInt::nextPrime(BigInt(-5)) == BigInt(2) && BigInt::nextPrime(BigInt(2)) == BigInt(3),
+          "nextPrime small");
+    check(BigInt::nextPrime(BigInt(999999937)) == BigInt(1000000007), "nextPrime across a limb");
+    check(BigInt::nextPrime(e18) == e18 + BigInt(3), "nextPrime 10^18");
+    check(BigInt::nextPrime(e100) == e100 + BigInt(267), "nextPrime 10^100");
+}
+
+void test_rns() {
+    const BigIntRNS::Basis basis(2000);
+    const BigInt product = basis.product();
+    check(product > BigInt::pow(BigInt(2), 2002), "basis covers 2^2002");
+    const BigInt half = product / BigInt(2);
+
+    // 余りと往復。表せる範囲は -M/2 < x <= M/2 で、超えると M を法として戻る
+    const BigInt values[] = {
+        BigInt(0), BigInt(1), BigInt(-1), BigInt(digit_string(500, 36)),
+        -BigInt(digit_string(600, 360)), half, -half + BigInt(1)
+    };
+    for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        BigIntRNS x(basis, values[i]);
+        check(x.toBigInt() == values[i], "RNS round trip " + values[i].toString().substr(0, 20));
+        for (std::size_t j = 0; j < basis.size(); j += 17) {
+            BigInt m(basis.modulus(j));
+            BigInt r = values[i] % m;
+            if (r.isNegative()) {
+                r += m;
+            }
+            check(BigInt(x.residue(j)) == r, "RNS residue");
+        }
+    }
+    check(BigIntRNS(basis, half + BigInt(1)).toBigInt() == half + BigInt(1) - product,
+          "RNS wraps above M/2");
+    check(BigIntRNS(basis, product).toBigInt().isZero(), "RNS M is 0");
+
+    // 積和を余りのまま回して最後に戻す
+    BigIntRNS acc(basis);
+    BigInt expected;
+    for (unsigned int i = 0; i < 20; ++i) {
+        BigInt x(digit_string(280, 3600 + i)), y(digit_string(290, 3700 + i));
+        if (i % 3 == 0) {
+            y = -y;
+        }
+        acc += BigIntRNS(basis, x) * BigIntRNS(basis, y);
+        acc -= BigIntRNS(basis, x);
+        expected += x * y - x;
+    }
+    check(acc.toBigInt() == expected, "RNS multiply-accumulate");
+    check((-acc).toBigInt() == -expected && acc == BigIntRNS(basis, expected)
+          && acc != BigIntRNS(basis, expected + BigInt(1)), "RNS negate and compare");
+
+    const BigIntRNS::Basis other(2000);
+    bool thrown = false;
+    try {
+        acc += BigIntRNS(other, BigInt(1));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "RNS basis mismatch");
+}
+
+// a = q * b + r (0 <= r < b) を作ってから割り、q と r が戻るか
+void check_known_division(const BigInt& q, const BigInt& b, const BigInt& r,
+                          const std::string& what) {
+    BigInt quotient, remainder;
+    BigInt::divmod(q * b + r, b, quotient, remainder);
+    check(quotient == q && remainder == r, "division " + what);
+}
+
+void test_division() {
+    // DIVISION_THRESHOLD (既定 70 limb) の前後と Burnikel-Ziegler の再帰が 1, 2 段入る大きさ
+    const std::size_t limbs[] = { 1, 2, 3, 69, 70, 71, 140, 141, 300 };
+    for (std::size_t i = 0; i < sizeof(limbs) / sizeof(limbs[0]); ++i) {
+        const std::size_t n = limbs[i];
+        const std::string size = BigInt(static_cast<unsigned long>(n)).toString() + " limbs";
+        const BigInt nines = BigInt::pow(BigInt(10), 9 * n) - BigInt(1);
+        const BigInt one_top = BigInt::pow(BigInt(10), 9 * (n - 1)) + BigInt(1);
+        const BigInt half_top = BigInt::pow(BigInt(10), 9 * n) / BigInt(2) + BigInt(7);
+        const BigInt random(digit_string(9 * n, 37 + n));
+        const BigInt divisors[] = { nines, one_top, half_top, random };
+        for (std::size_t j = 0; j < sizeof(divisors) / sizeof(divisors[0]); ++j) {
+            const BigInt& b = divisors[j];
+            // 除数が 10^(9n) - 1 で剰余が b - 1 のとき、n >= 3 なら q_hat が
+            // 2 limb の判定を通ったまま 1 大きく、足し戻しの経路を通る
+            const BigInt qs[] = {
+                BigInt(1), BigInt::pow(BigInt(10), 9 * n) - BigInt(1),
+                BigInt::pow(BigInt(10), 9 * (2 * n + 1)) - BigInt(1),
+                BigInt(digit_string(9 * n + 5, 370 + n))
+            };
+            for (std::size_t k = 0; k < sizeof(qs) / sizeof(qs[0]); ++k) {
+                check_known_division(qs[k], b, b - BigInt(1), size);
+                check_known_division(qs[k], b, BigInt(0), size);
+                check_known_division(qs[k], b, random % b, size);
+            }
+        }
+    }
+}
+
+std::string decimal_text(const std::string& value, long exponent,
+                         BigDecimal::RoundingMode mode) {
+    return BigDecimal(value).rescale(exponent, mode).toString();
+}
+
+void test_decimal() {
+    // java.math.RoundingMode の説明にある表
+    const char* inputs[] = { "5.5", "2.5", "1.6", "1.1", "1.0", "-1.0", "-1.1", "-1.6", "-2.5", "-5.5" };
+    const BigDecimal::RoundingMode modes[] = {
+        BigDecimal::ROUND_UP, BigDecimal::ROUND_DOWN, BigDecimal::ROUND_CEILING,
+        BigDecimal::ROUND_FLOOR, BigDecimal::ROUND_HALF_UP, BigDecimal::ROUND_HALF_DOWN,
+        BigDecimal::ROUND_HALF_EVEN
+    };
+    const int expected[7][10] = {
+        { 6, 3, 2, 2, 1, -1, -2, -2, -3, -6 },
+        { 5, 2, 1, 1, 1, -1, -1, -1, -2, -5 },
+        { 6, 3, 2, 2, 1, -1, -1, -1, -2, -5 },
+        { 5, 2, 1, 1, 1, -1, -2, -2, -3, -6 },
+        { 6, 3, 2, 1, 1, -1, -1, -2, -3, -6 },
+        { 5, 2, 2, 1, 1, -1, -1, -2, -2, -5 },
+        { 6, 2, 2, 1, 1, -1, -1, -2, -2, -6 }
+    };
+    for (std::size_t m = 0; m < 7; ++m) {
+        for (std::size_t i = 0; i < 10; ++i) {
+            check(decimal_text(inputs[i], 0, modes[m]) == BigInt(expected[m][i]).toString(),
+                  std::string("rounding table ") + inputs[i] + " mode "
+                  + BigInt(static_cast<int>(m)).toString());
+        }
+    }
+
+    // 捨てる桁が limb をまたぐときの半分の判定
+    check(decimal_text("2.5000000000000000001", 0, BigDecimal::ROUND_HALF_EVEN) == "3",
+          "half-even with sticky digits");
+    check(decimal_text("2.50000000000000000000", 0, BigDecimal::ROUND_HALF_EVEN) == "2",
+          "half-even exact half");
+    check(decimal_text("0.0000000000000000004999", -18, BigDecimal::ROUND_HALF_UP)
+          == "0.000000000000000000", "below half");
+    check(decimal_text("123456789.987654321", -4, BigDecimal::ROUND_HALF_UP) == "123456789.9877",
+          "rescale within a limb");
+    check(decimal_text("-1.5", -3, BigDecimal::ROUND_UP) == "-1.500", "rescale down is exact");
+
+    // 除算は指定した指数まで求めて丸める
+    const BigDecimal one("1"), two("2"), three("3"), eight("8");
+    check(one.divide(three, -20).toString() == "0.33333333333333333333", "1 / 3");
+    check(two.divide(three, -20, BigDecimal::ROUND_HALF_UP).toString()
+          == "0.66666666666666666667", "2 / 3");
+    check((-one).divide(eight, -2).toString() == "-0.12", "-1 / 8 half-even");
+    check((-one).divide(eight, -2, BigDecimal::ROUND_FLOOR).toString() == "-0.13", "-1 / 8 floor");
+
+    // 解析・表記・値としての比較
+    check(BigDecimal("6.02E+23").toString() == "602000000000000000000000", "parse exponent");
+    check(BigDecimal("1e-7").toString() == "0.0000001", "parse negative exponent");
+    check(BigDecimal("1.2300").stripTrailingZeros().toString() == "1.23"
+          && BigDecimal("1.2300").stripTrailingZeros().exponent() == -2, "stripTrailingZeros");
+    check(BigDecimal("1.0") == BigDecimal("1.00") && BigDecimal("0.1") < BigDecimal("0.11")
+          && BigDecimal("-0.5") < BigDecimal("0"), "value comparison");
+    check((BigDecimal("0.1") + BigDecimal("0.2")).toString() == "0.3"
+          && (BigDecimal("1.5") * BigDecimal("-0.25")).toString() == "-0.375"
+          && (BigDecimal("1") - BigDecimal("0.001")).toString() == "0.999", "exact arithmetic");
+    // 指数が大きく離れていても、比較と 0 との加減算は桁を揃えない
+    const BigDecimal huge("1e1000000000000"), tiny("-1e-1000000000000");
+    check(huge > one && tiny < BigDecimal("0") && tiny > BigDecimal("-1") && huge > tiny
+          && huge == BigDecimal("10e999999999999")
+          && BigDecimal("-1e9000000000000000000") < BigDecimal("-1e-9000000000000000000"),
+          "compare far-apart exponents");
+    check((huge + BigDecimal()).exponent() == 1000000000000
+          && (BigDecimal("0.000") - huge) == -huge && (tiny - BigDecimal()) == tiny,
+          "add zero with far-apart exponent");
+    int thrown = 0;
+    const char* invalid[] = { "", "-", "1.2.3", "1e", "abc" };
+    for (std::size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        try {
+            BigDecimal x(invalid[i]);
+            (void)x;
+        } catch (const std::invalid_argument&) {
+            ++thrown;
+        }
+    }
+    check(thrown == 5, "invalid decimals");
+}
+
+void test_hash() {
+    // == な値は作り方によらず同じハッシュ値
+    check(BigInt().hash() == BigInt(0).hash() && BigInt("-0").hash() == BigInt(0).hash()
+          && (BigInt(5) - BigInt(5)).hash() == BigInt().hash(), "zero hashes");
+    check(BigInt(5).hash() != BigInt(-5).hash(), "sign changes the hash");
+    BigIntHash hasher;
+    for (unsigned int i = 0; i < 50; ++i) {
+        const std::string text = digit_string(1 + i * 23, 40 + i);
+        BigInt parsed(text);
+        BigInt computed = BigInt(text + "7") / BigInt(10);
+        std::size_t before = parsed.hash();
+        check(before == computed.hash() && hasher(parsed) == before
+              && BigInt(parsed).hash() == before, "equal values hash equal " + text.substr(0, 20));
+        // 書き換えたら (HASH_CACHE でも) 新しい値のハッシュになる
+        ++parsed;
+        check(parsed.hash() == (computed + BigInt(1)).hash(), "hash after ++ " + text.substr(0, 20));
+        --parsed;
+        check(parsed.hash() == before, "hash after -- " + text.substr(0, 20));
+        std::istringstream in("-" + text);
+        in >> parsed;
+        check(parsed.hash() == (-computed).hash(), "hash after >> " + text.substr(0, 20));
+    }
+
+    // ハッシュ表のキーとして、別に作った等しい値で引ける
+    std::tr1::unordered_map<BigInt, int, BigIntHash> table;
+    for (int i = 0; i < 1000; ++i) {
+        table[BigInt::pow(BigInt(3), i) - BigInt(i)] = i;
+    }
+    bool found = table.size() == 1000;
+    std::set<std::size_t> hashes;
+    for (int i = 0; i < 1000; ++i) {
+        BigInt key(BigInt::pow(BigInt(3), i).toString());
+        key -= BigInt(i);
+        std::tr1::unordered_map<BigInt, int, BigIntHash>::const_iterator it = table.find(key);
+        found = found && it != table.end() && it->second == i;
+        hashes.insert(key.hash());
+    }
+    check(found, "unordered_map lookups");
+    check(hashes.size() == 1000, "no collisions among 3^i - i");
+}
+
+typedef FixedBigInt<4> Fixed4;
+
+// 四則演算が同じ値の BigInt と一致するか
+void check_fixed_ops(const std::string& a, const std::string& b) {
+    BigInt x(a), y(b);
+    Fixed4 fx(a), fy(b);
+    const std::string what = " on " + a + ", " + b;
+    check((fx + fy).toBigInt() == x + y, "Fixed +" + what);
+    check((fx - fy).toBigInt() == x - y, "Fixed -" + what);
+    if (!y.isZero()) {
+        check((fx / fy).toBigInt() == x / y, "Fixed /" + what);
+        check((fx % fy).toBigInt() == x % y, "Fixed %" + what);
+    }
+    check(fx.compare(fy) == x.compare(y), "Fixed compare" + what);
+}
+
+void test_fixed_bigint() {
+    check_fixed_ops("123456789012345678", "987654321");
+    check_fixed_ops("-999999999999999999999999999", "1000000000");
+    check_fixed_ops("99999999999999999999999999999999999", "-999999999999999999");
+    check_fixed_ops("100000000000000000000000000000000000", "99999999999999999999");
+    check_fixed_ops("-5", "7");
+    check_fixed_ops("0", "-3");
+    check((Fixed4(std::string("123456789123456789")) * Fixed4(987654321)).toBigInt()
+          == BigInt("123456789123456789") * BigInt(987654321), "Fixed *");
+    check(Fixed4(-6) * Fixed4(7) == Fixed4(-42), "Fixed * sign");
+    check(Fixed4(std::string("-0")).toString() == "0", "Fixed -0");
+
+    // 36 桁を超える結果は例外
+    const Fixed4 max(std::string(36, '9'));
+    bool thrown = false;
+    try {
+        Fixed4 y = max + Fixed4(1);
+        (void)y;
+    } catch (const std::overflow_error&) {
+        thrown = true;
+    }
+    check(thrown, "Fixed + overflow");
+    thrown = false;
+    try {
+        Fixed4 y = max * max;
+        (void)y;
+    } catch (const std::overflow_error&) {
+        thrown = true;
+    }
+    check(thrown, "Fixed * overflow");
+    thrown = false;
+    try {
+        Fixed4 y = max / Fixed4();
+        (void)y;
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    check(thrown, "Fixed / 0");
+}
+
+}  // namespace
 
 int main() {
     {
@@ -82,4 +943,28 @@ int main() {
         std::cout << "10 ^ 1000: " << q << std::endl;
         std::cout << "Are they equal? " << (p == q ? "Yes" : "No") << std::endl;
     }
+
+    run_test("stream", test_stream);
+    run_test("radix", test_radix);
+    run_test("compare", test_compare);
+    run_test("divmod", test_divmod);
+    run_test("thresholds", test_thresholds);
+    run_test("stats", test_stats);
+    run_test("FixedBigInt", test_fixed_bigint);
+    run_test("batch", test_batch);
+    run_test("copy-on-write", test_copy_on_write);
+    run_test("primes", test_primes);
+    run_test("RNS", test_rns);
+    run_test("division", test_division);
+    run_test("BigDecimal", test_decimal);
+    run_test("integer constructors", test_integer_constructors);
+    run_test("conversions", test_conversions);
+    run_test("hash", test_hash);
+
+    if (g_failures > 0) {
+        std::cout << g_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
 }